@@ -0,0 +1,306 @@
+/**
+ * @file ring_executor.h
+ * @brief C++20 coroutine consumers for SPSCRingBuffer on a single-threaded executor.
+ * * For non-critical services that consume many low-rate rings: instead of one
+ * spinning thread per queue, one executor thread polls every ring that a
+ * suspended coroutine is waiting on and resumes the coroutines whose data
+ * has arrived.
+ *
+ *   async::Task consume(Ring& ring) {
+ *       for (;;) {
+ *           Order o = co_await async::pop(ring);
+ *           handle(o);
+ *       }
+ *   }
+ *   async::RingExecutor ex;
+ *   ex.spawn(consume(ring));
+ *   ex.run();
+ *
+ * - Zero allocation after spawn: waiting awaitables are linked intrusively
+ *   from the coroutine frames they live in.
+ * - A coroutine keeps running while data is available, up to BatchBudget
+ *   consecutive pops, then yields to the other consumers.
+ * - When a full sweep finds every ring empty the executor backs off
+ *   (pause, then yield, then sleep) instead of burning the core.
+ * - The executor thread is the consumer of every ring it polls; producers
+ *   may be on any thread, as with any SPSCRingBuffer.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <immintrin.h>
+
+namespace fwilliamsca {
+namespace async {
+
+    class RingExecutor;
+
+    /**
+     * @brief Fire-and-forget coroutine owned by a RingExecutor once spawned.
+     * Exceptions escaping the coroutine terminate the process.
+     */
+    class Task {
+    public:
+        struct promise_type {
+            RingExecutor* executor = nullptr;
+
+            Task get_return_object() {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+            ~promise_type();
+        };
+
+        Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                if (handle_) handle_.destroy();
+                handle_ = std::exchange(other.handle_, nullptr);
+            }
+            return *this;
+        }
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task() {
+            if (handle_) handle_.destroy();
+        }
+
+    private:
+        friend class RingExecutor;
+        explicit Task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    /**
+     * @brief Intrusive record of a coroutine suspended on a ring.
+     */
+    struct Waiter {
+        bool (*poll)(Waiter*) = nullptr;    // Attempts the pop; true when the value is ready
+        std::coroutine_handle<> handle;
+        Waiter* next = nullptr;
+    };
+
+    /**
+     * @brief Backoff applied when a sweep finds no ready coroutine.
+     */
+    struct ParkPolicy {
+        uint32_t spin_sweeps = 64;                              // Empty sweeps with PAUSE only
+        uint32_t yield_sweeps = 64;                             // Then empty sweeps with yield()
+        std::chrono::microseconds min_sleep{50};                // Then sleep, doubling up to max_sleep
+        std::chrono::microseconds max_sleep{1000};
+    };
+
+    class RingExecutor {
+    public:
+        // Consecutive immediate pops a coroutine may perform before yielding
+        static constexpr uint32_t BatchBudget = 64;
+
+        explicit RingExecutor(ParkPolicy park = {}) : park_(park) {}
+
+        RingExecutor(const RingExecutor&) = delete;
+        RingExecutor& operator=(const RingExecutor&) = delete;
+
+        ~RingExecutor() {
+            // Destroying a suspended frame runs its destructors; in-flight
+            // awaitables are simply forgotten.
+            for (auto h : ready_) h.destroy();
+            for (Waiter* w = head_; w;) {
+                Waiter* next = w->next;
+                w->handle.destroy();
+                w = next;
+            }
+        }
+
+        /**
+         * @brief Takes ownership of a task; it starts on the next sweep.
+         * Returns false, queueing nothing, for an empty (moved-from) task.
+         */
+        bool spawn(Task task) {
+            auto h = std::exchange(task.handle_, nullptr);
+            if (!h) return false;
+            h.promise().executor = this;
+            ++live_tasks_;
+            ready_.push_back(h);
+            return true;
+        }
+
+        /**
+         * @brief One pass: starts spawned tasks, then polls every waiting
+         * coroutine once and resumes those whose ring produced a value.
+         * @return Number of coroutines resumed.
+         */
+        size_t run_once() {
+            Scope scope(this);
+            size_t resumed = 0;
+
+            if (!ready_.empty()) {
+                starting_.swap(ready_);
+                for (auto h : starting_) {
+                    resume(h);
+                    ++resumed;
+                }
+                starting_.clear();
+            }
+
+            // Detach the list so waiters registered during this sweep wait for the next one
+            Waiter* pending = head_;
+            head_ = nullptr;
+            tail_ = nullptr;
+            while (pending) {
+                Waiter* w = pending;
+                pending = w->next;
+                w->next = nullptr;
+                if (w->poll(w)) {
+                    resume(w->handle);
+                    ++resumed;
+                } else {
+                    enqueue(w);
+                }
+            }
+            return resumed;
+        }
+
+        /**
+         * @brief Runs until every task has completed or stop() is called.
+         */
+        void run() {
+            stop_ = false;
+            uint32_t idle_sweeps = 0;
+            auto sleep = park_.min_sleep;
+            while (!stop_ && live_tasks_ != 0) {
+                if (run_once() != 0) {
+                    idle_sweeps = 0;
+                    sleep = park_.min_sleep;
+                    continue;
+                }
+                ++idle_sweeps;
+                if (idle_sweeps <= park_.spin_sweeps) {
+                    _mm_pause();
+                } else if (idle_sweeps <= park_.spin_sweeps + park_.yield_sweeps) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(sleep);
+                    if (sleep < park_.max_sleep) sleep *= 2;
+                    if (sleep > park_.max_sleep) sleep = park_.max_sleep;
+                }
+            }
+        }
+
+        /**
+         * @brief Makes run() return after the current sweep (call from a task).
+         */
+        void stop() { stop_ = true; }
+
+        size_t live_tasks() const { return live_tasks_; }
+
+        /**
+         * @brief Executor driving the calling thread (nullptr outside run()).
+         */
+        static RingExecutor* current() { return current_; }
+
+        // Used by awaitables
+        uint32_t& budget() { return budget_; }
+        void enqueue(Waiter* w) {
+            w->next = nullptr;
+            if (tail_) {
+                tail_->next = w;
+            } else {
+                head_ = w;
+            }
+            tail_ = w;
+        }
+
+    private:
+        friend struct Task::promise_type;
+
+        struct Scope {
+            RingExecutor* previous;
+            explicit Scope(RingExecutor* ex) : previous(current_) { current_ = ex; }
+            ~Scope() { current_ = previous; }
+        };
+
+        void resume(std::coroutine_handle<> h) {
+            budget_ = BatchBudget;
+            h.resume();
+        }
+
+        ParkPolicy park_;
+        std::vector<std::coroutine_handle<>> ready_;
+        std::vector<std::coroutine_handle<>> starting_;
+        Waiter* head_ = nullptr;
+        Waiter* tail_ = nullptr;
+        size_t live_tasks_ = 0;
+        uint32_t budget_ = 0;
+        bool stop_ = false;
+
+        static inline thread_local RingExecutor* current_ = nullptr;
+    };
+
+    inline Task::promise_type::~promise_type() {
+        if (executor) --executor->live_tasks_;
+    }
+
+    /**
+     * @brief Awaitable returned by pop(ring); yields the dequeued value.
+     */
+    template <typename Ring>
+    class PopAwaitable : private Waiter {
+    public:
+        using value_type = typename Ring::value_type;
+
+        explicit PopAwaitable(Ring& ring) : ring_(ring) {}
+
+        bool await_ready() {
+            RingExecutor* ex = RingExecutor::current();
+            assert(ex && "co_await async::pop() outside RingExecutor::run()");
+            uint32_t& budget = ex->budget();
+            if (budget != 0 && ring_.try_pop(value_)) {
+                --budget;
+                return true;
+            }
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            poll = &PopAwaitable::try_complete;
+            handle = h;
+            RingExecutor::current()->enqueue(this);
+        }
+
+        value_type await_resume() { return std::move(value_); }
+
+    private:
+        static bool try_complete(Waiter* w) {
+            auto* self = static_cast<PopAwaitable*>(w);
+            return self->ring_.try_pop(self->value_);
+        }
+
+        Ring& ring_;
+        value_type value_{};
+    };
+
+    /**
+     * @brief co_await pop(ring) suspends until ring yields a value.
+     */
+    template <typename Ring>
+    PopAwaitable<Ring> pop(Ring& ring) {
+        return PopAwaitable<Ring>(ring);
+    }
+
+} // namespace async
+} // namespace fwilliamsca
@@ -0,0 +1,352 @@
+/**
+ * @file alloc_guard.h
+ * @brief Hot-path allocation detector (malloc interposition + scoped guards).
+ * * "Zero-allocation on the hot path" is only a promise until something
+ * checks it. HotPathGuard marks a scope on the calling thread; every
+ * malloc-family call and every global operator new (plain, array, nothrow
+ * and aligned; replaced directly, so they count even where new does not
+ * go through malloc, as with libc++) made by that thread inside the
+ * scope is counted, and with AllocPolicy::Abort the first one prints a
+ * backtrace and aborts. Guards nest; the innermost policy wins. Allocations
+ * on other threads are not attributed to the scope.
+ *
+ * The interposed malloc/free and operator new/delete are defined by exactly
+ * one translation unit of the executable (glibc only; skipped under
+ * ASan/TSan, which interpose too):
+ *   #define FWILLIAMSCA_ALLOC_GUARD_HOOKS
+ *   #include "fwilliamsca/bench/alloc_guard.h"
+ * Without them guards count nothing; alloc_hooks_installed() tells which.
+ *
+ * Usage:
+ *   bench::HotPathGuard guard(bench::AllocPolicy::Count, 8);  // keep 8 stacks
+ *   ring.try_push(msg);
+ *   if (guard.stats().allocations) guard.print_stacks(stderr);
+ */
+
+#pragma once
+
+#include <execinfo.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace fwilliamsca {
+namespace bench {
+
+    enum class AllocPolicy {
+        Count,      // Record and continue
+        Abort       // Print the offending stack to stderr and abort()
+    };
+
+    struct AllocStats {
+        uint64_t allocations = 0;   // malloc/calloc/realloc/aligned/operator new calls
+        uint64_t bytes = 0;         // Requested bytes
+        uint64_t frees = 0;         // free()/operator delete of non-null pointers
+    };
+
+    namespace detail {
+
+        constexpr int AllocStackDepth = 32;
+
+        struct AllocStack {
+            void* frames[AllocStackDepth];
+            int depth;
+            size_t bytes;
+        };
+
+        // Preallocated by the guard so the hook never allocates
+        struct AllocCapture {
+            AllocStack* stacks;
+            size_t capacity;
+            size_t count;
+        };
+
+        // Constant-initialized and trivially destructible: safe to touch from malloc
+        struct AllocThreadState {
+            uint64_t allocations;
+            uint64_t bytes;
+            uint64_t frees;
+            int depth;
+            AllocPolicy policy;
+            AllocCapture* capture;
+            bool in_hook;
+        };
+
+        inline thread_local AllocThreadState alloc_state = {0, 0, 0, 0, AllocPolicy::Count, nullptr, false};
+
+        inline void report_and_abort(size_t bytes) {
+            char msg[128];
+            const int len = std::snprintf(msg, sizeof(msg),
+                                          "HotPathGuard: %zu-byte allocation inside a no-allocation scope\n", bytes);
+            if (len > 0) (void)!::write(STDERR_FILENO, msg, static_cast<size_t>(len));
+            void* frames[AllocStackDepth];
+            const int depth = ::backtrace(frames, AllocStackDepth);
+            ::backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+            std::abort();
+        }
+
+        /**
+         * @brief Called by the interposed allocator before every allocation.
+         */
+        inline void on_allocation(size_t bytes) {
+            AllocThreadState& s = alloc_state;
+            if (s.depth == 0 || s.in_hook) return;
+            s.in_hook = true;    // backtrace() may allocate on first use
+            ++s.allocations;
+            s.bytes += bytes;
+            if (s.policy == AllocPolicy::Abort) report_and_abort(bytes);
+            AllocCapture* c = s.capture;
+            if (c && c->count < c->capacity) {
+                AllocStack& st = c->stacks[c->count++];
+                st.depth = ::backtrace(st.frames, AllocStackDepth);
+                st.bytes = bytes;
+            }
+            s.in_hook = false;
+        }
+
+        inline void on_free() {
+            AllocThreadState& s = alloc_state;
+            if (s.depth != 0 && !s.in_hook) ++s.frees;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Marks a no-allocation scope on the calling thread. Must be
+     * destroyed on the thread that created it.
+     */
+    class HotPathGuard {
+    public:
+        /**
+         * @param policy Count or Abort on the first allocation.
+         * @param capture_stacks Keep backtraces of the first N allocations.
+         */
+        explicit HotPathGuard(AllocPolicy policy = AllocPolicy::Count, size_t capture_stacks = 0)
+            : stacks_(capture_stacks) {
+            detail::AllocThreadState& s = detail::alloc_state;
+            if (capture_stacks != 0 || policy == AllocPolicy::Abort) {
+                // Load the unwinder now rather than inside the guarded scope
+                void* frame;
+                ::backtrace(&frame, 1);
+            }
+            capture_ = {stacks_.data(), stacks_.size(), 0};
+            prev_policy_ = s.policy;
+            prev_capture_ = s.capture;
+            start_ = {s.allocations, s.bytes, s.frees};
+            s.policy = policy;
+            if (capture_stacks != 0) s.capture = &capture_;
+            ++s.depth;
+        }
+
+        ~HotPathGuard() {
+            detail::AllocThreadState& s = detail::alloc_state;
+            --s.depth;
+            s.policy = prev_policy_;
+            s.capture = prev_capture_;
+        }
+
+        HotPathGuard(const HotPathGuard&) = delete;
+        HotPathGuard& operator=(const HotPathGuard&) = delete;
+
+        /**
+         * @brief Allocations since construction (nested guards included).
+         */
+        AllocStats stats() const {
+            const detail::AllocThreadState& s = detail::alloc_state;
+            return {s.allocations - start_.allocations, s.bytes - start_.bytes, s.frees - start_.frees};
+        }
+
+        size_t stack_count() const { return capture_.count; }
+
+        /**
+         * @brief Symbolized backtraces of the captured allocations.
+         */
+        void print_stacks(std::FILE* out) const {
+            for (size_t i = 0; i < capture_.count; ++i) {
+                std::fprintf(out, "allocation #%zu (%zu bytes):\n", i + 1, stacks_[i].bytes);
+                std::fflush(out);
+                ::backtrace_symbols_fd(stacks_[i].frames, stacks_[i].depth, ::fileno(out));
+            }
+        }
+
+    private:
+        std::vector<detail::AllocStack> stacks_;
+        detail::AllocCapture capture_;
+        AllocPolicy prev_policy_;
+        detail::AllocCapture* prev_capture_;
+        AllocStats start_;
+    };
+
+    /**
+     * @brief True if this executable links the interposed allocator.
+     */
+    inline bool alloc_hooks_installed() {
+        static const bool installed = []() {
+            // Through a volatile pointer so the pair cannot be elided
+            void* (*volatile alloc)(size_t) = std::malloc;
+            HotPathGuard guard;
+            void* p = alloc(16);
+            std::free(p);
+            return guard.stats().allocations != 0;
+        }();
+        return installed;
+    }
+
+} // namespace bench
+} // namespace fwilliamsca
+
+#if defined(FWILLIAMSCA_ALLOC_GUARD_HOOKS) && defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && \
+    !defined(__SANITIZE_THREAD__)
+
+// glibc's real allocator, exported under these names for exactly this purpose
+extern "C" {
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void* __libc_valloc(size_t);
+    void* __libc_pvalloc(size_t);
+    void __libc_free(void*);
+
+    void* malloc(size_t n) noexcept {
+        fwilliamsca::bench::detail::on_allocation(n);
+        return __libc_malloc(n);
+    }
+
+    void* calloc(size_t count, size_t n) noexcept {
+        fwilliamsca::bench::detail::on_allocation(count * n);
+        return __libc_calloc(count, n);
+    }
+
+    void* realloc(void* p, size_t n) noexcept {
+        fwilliamsca::bench::detail::on_allocation(n);
+        return __libc_realloc(p, n);
+    }
+
+    void* memalign(size_t align, size_t n) noexcept {
+        fwilliamsca::bench::detail::on_allocation(n);
+        return __libc_memalign(align, n);
+    }
+
+    void* aligned_alloc(size_t align, size_t n) noexcept {
+        fwilliamsca::bench::detail::on_allocation(n);
+        return __libc_memalign(align, n);
+    }
+
+    int posix_memalign(void** out, size_t align, size_t n) noexcept {
+        if (align % sizeof(void*) != 0 || (align & (align - 1)) != 0) return EINVAL;
+        fwilliamsca::bench::detail::on_allocation(n);
+        void* p = __libc_memalign(align, n);
+        if (!p) return ENOMEM;
+        *out = p;
+        return 0;
+    }
+
+    void* valloc(size_t n) noexcept {
+        fwilliamsca::bench::detail::on_allocation(n);
+        return __libc_valloc(n);
+    }
+
+    void* pvalloc(size_t n) noexcept {
+        fwilliamsca::bench::detail::on_allocation(n);
+        return __libc_pvalloc(n);
+    }
+
+    void free(void* p) noexcept {
+        if (p) fwilliamsca::bench::detail::on_free();
+        __libc_free(p);
+    }
+}
+
+namespace fwilliamsca {
+namespace bench {
+namespace detail {
+
+    // Counted once, then the usual new_handler loop on glibc's allocator
+    inline void* hooked_new(size_t n, size_t align) {
+        on_allocation(n);
+        if (n == 0) n = 1;
+        for (;;) {
+            void* p = align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? __libc_malloc(n) : __libc_memalign(align, n);
+            if (p) return p;
+            const std::new_handler handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    inline void* hooked_new_nothrow(size_t n, size_t align) noexcept {
+        try {
+            return hooked_new(n, align);
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    inline void hooked_delete(void* p) noexcept {
+        if (p) on_free();
+        __libc_free(p);
+    }
+
+} // namespace detail
+} // namespace bench
+} // namespace fwilliamsca
+
+// Replaceable global allocation functions: counted here, not via malloc, so
+// the guard holds whatever the standard library's own operator new does
+void* operator new(size_t n) {
+    return fwilliamsca::bench::detail::hooked_new(n, 0);
+}
+
+void* operator new[](size_t n) {
+    return fwilliamsca::bench::detail::hooked_new(n, 0);
+}
+
+void* operator new(size_t n, const std::nothrow_t&) noexcept {
+    return fwilliamsca::bench::detail::hooked_new_nothrow(n, 0);
+}
+
+void* operator new[](size_t n, const std::nothrow_t&) noexcept {
+    return fwilliamsca::bench::detail::hooked_new_nothrow(n, 0);
+}
+
+void* operator new(size_t n, std::align_val_t align) {
+    return fwilliamsca::bench::detail::hooked_new(n, static_cast<size_t>(align));
+}
+
+void* operator new[](size_t n, std::align_val_t align) {
+    return fwilliamsca::bench::detail::hooked_new(n, static_cast<size_t>(align));
+}
+
+void* operator new(size_t n, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return fwilliamsca::bench::detail::hooked_new_nothrow(n, static_cast<size_t>(align));
+}
+
+void* operator new[](size_t n, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return fwilliamsca::bench::detail::hooked_new_nothrow(n, static_cast<size_t>(align));
+}
+
+void operator delete(void* p) noexcept { fwilliamsca::bench::detail::hooked_delete(p); }
+void operator delete[](void* p) noexcept { fwilliamsca::bench::detail::hooked_delete(p); }
+void operator delete(void* p, size_t) noexcept { fwilliamsca::bench::detail::hooked_delete(p); }
+void operator delete[](void* p, size_t) noexcept { fwilliamsca::bench::detail::hooked_delete(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { fwilliamsca::bench::detail::hooked_delete(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { fwilliamsca::bench::detail::hooked_delete(p); }
+void operator delete(void* p, std::align_val_t) noexcept { fwilliamsca::bench::detail::hooked_delete(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { fwilliamsca::bench::detail::hooked_delete(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { fwilliamsca::bench::detail::hooked_delete(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { fwilliamsca::bench::detail::hooked_delete(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    fwilliamsca::bench::detail::hooked_delete(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    fwilliamsca::bench::detail::hooked_delete(p);
+}
+
+#endif
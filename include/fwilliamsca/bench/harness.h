@@ -0,0 +1,596 @@
+/**
+ * @file harness.h
+ * @brief Statistical micro-benchmark harness.
+ * * A single timed batch hides variance, frequency ramp-up and outliers. Each
+ * registered benchmark is instead run as:
+ *   1. Calibration: pick a batch size K so one sample lasts >= min_sample_time.
+ *   2. Warm-up: take samples until the median of the last window stops
+ *      moving (or max_warmup_time elapses), discarding them.
+ *   3. Measurement: take `samples` timed batches; report per-iteration
+ *      median, MAD, percentiles and a 95% CI of the median.
+ *
+ * With Config::perf (--perf) the measurement phase is also bracketed by a
+ * PerfCounterGroup and reported as IPC plus per-element (or per-iteration)
+ * miss rates; hosts without PMU access print the reason instead.
+ *
+ * With Config::alloc_check (--alloc-check) the measuring thread runs the
+ * measurement phase under a HotPathGuard (bench/alloc_guard.h). Benchmarks
+ * registered with ->no_alloc() fail if op() allocated at all.
+ *
+ * Usage:
+ *   void bench_add(bench::State& state) {
+ *       std::vector<double> a(state.size()), b(state.size()), out(state.size());
+ *       state.set_bytes_per_iteration(3 * state.size() * sizeof(double));
+ *       state.run([&]() {
+ *           simd::MathKernel<>::add(a.data(), b.data(), out.data(), state.size());
+ *           bench::ClobberMemory();
+ *       });
+ *   }
+ *   FWILLIAMSCA_BENCHMARK(bench_add)->sizes({1 << 10, 1 << 20});
+ *
+ *   int main(int argc, char** argv) { return bench::run_all(argc, argv); }
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "alloc_guard.h"
+#include "perf_counters.h"
+#include "statistics.h"
+#include "../timing/tsc_clock.h"
+#include "../metrics/latency_histogram.h"
+
+namespace fwilliamsca {
+namespace bench {
+
+    /**
+     * @brief Forces value to be materialized (prevents dead-code elimination).
+     */
+    template <typename T>
+    inline __attribute__((always_inline)) void DoNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    template <typename T>
+    inline __attribute__((always_inline)) void DoNotOptimize(T& value) {
+#if defined(__clang__)
+        asm volatile("" : "+r,m"(value) : : "memory");
+#else
+        // GCC mishandles multi-alternative in/out operands here; memory is always correct
+        asm volatile("" : "+m"(value) : : "memory");
+#endif
+    }
+
+    /**
+     * @brief Compiler barrier: all pending memory writes are assumed observed.
+     */
+    inline __attribute__((always_inline)) void ClobberMemory() {
+        asm volatile("" : : : "memory");
+    }
+
+    struct Config {
+        double min_sample_time = 1e-3;      // Seconds per sample (drives batch size)
+        double max_warmup_time = 0.5;       // Seconds
+        double max_time = 3.0;              // Seconds of measurement per benchmark instance
+        size_t samples = 30;
+        size_t warmup_window = 5;
+        double warmup_tolerance = 0.02;     // Relative median change considered stable
+        std::string filter;                 // Substring match on the full instance name
+        bool perf = false;                  // Collect hardware counters during measurement
+        std::vector<PerfEvent> perf_events = default_perf_events();
+        bool alloc_check = false;           // Count allocations during measurement (needs the hooks)
+    };
+
+    /**
+     * @brief Counter value normalized per benchmark iteration.
+     */
+    struct CounterValue {
+        std::string name;
+        double per_iteration;
+    };
+
+    class Benchmark;
+
+    /**
+     * @brief Per-instance context handed to a benchmark function.
+     */
+    class State {
+    public:
+        State(const Config& cfg, size_t size, size_t max_samples)
+            : cfg_(cfg), size_(size), max_samples_(max_samples) {}
+
+        /**
+         * @brief Current value of the size sweep (0 if the benchmark has none).
+         */
+        size_t size() const { return size_; }
+
+        void set_items_per_iteration(double n) { items_ = n; }
+        void set_bytes_per_iteration(double n) { bytes_ = n; }
+        void set_flops_per_iteration(double n) { flops_ = n; }
+
+        /**
+         * @brief Per-event latency distribution (ns) for benchmarks that time
+         * individual events inside op(); printed as percentiles when non-empty.
+         */
+        metrics::LatencyHistogram<>& latency() { return latency_; }
+        const metrics::LatencyHistogram<>& latency() const { return latency_; }
+
+        /**
+         * @brief True only while run() takes measurement samples (not during
+         * calibration or warm-up).
+         */
+        bool measuring() const { return measuring_; }
+
+        /**
+         * @brief Adds a histogram of TSC ticks to latency(), converting each
+         * bucket at its midpoint. Ignored outside measurement samples, so
+         * op() may call it unconditionally.
+         */
+        void record_latency_ticks(const metrics::LatencyHistogram<>& ticks, double ns_per_tick) {
+            if (!measuring_) return;
+            for (size_t i = 0; i < ticks.BucketCount; ++i) {
+                if (const uint64_t c = ticks.bucket_count(i)) {
+                    latency_.record_n(static_cast<uint64_t>(ticks.bucket_midpoint(i) * ns_per_tick + 0.5), c);
+                }
+            }
+        }
+
+        /**
+         * @brief Marks the instance as skipped (e.g. unsupported on this host).
+         */
+        void skip(std::string reason) { skip_reason_ = std::move(reason); }
+
+        /**
+         * @brief Records a correctness failure; run_all() then exits non-zero.
+         */
+        void error(std::string message) { error_ = std::move(message); }
+
+        /**
+         * @brief Calibrates, warms up and samples op(). Call exactly once.
+         */
+        template <typename Op>
+        void run(Op&& op) {
+            // Serialized TSC reads net of their own cost; steady_clock if the TSC is not invariant
+            const timing::TscClock& tsc = timing::TscClock::instance();
+            tsc_ghz_ = tsc.invariant() ? tsc.ghz() : 0.0;
+            auto time_batch = [&](size_t k) {
+                if (tsc_ghz_ > 0.0) {
+                    const uint64_t t0 = timing::rdtsc_start();
+                    for (size_t i = 0; i < k; ++i) op();
+                    const uint64_t t1 = timing::rdtsc_stop();
+                    return tsc.elapsed_ns(t0, t1) * 1e-9;
+                }
+                const auto t0 = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < k; ++i) op();
+                const auto t1 = std::chrono::steady_clock::now();
+                return std::chrono::duration<double>(t1 - t0).count();
+            };
+
+            // 1. Calibration
+            size_t k = 1;
+            double t = time_batch(k);
+            while (t < cfg_.min_sample_time && k < (size_t(1) << 30)) {
+                const double scale = t > 0.0 ? cfg_.min_sample_time / t : 10.0;
+                k = static_cast<size_t>(static_cast<double>(k) * std::clamp(scale * 1.2, 2.0, 10.0));
+                t = time_batch(k);
+            }
+            batch_ = k;
+
+            // 2. Warm-up until the windowed median stabilizes
+            std::vector<double> warm;
+            double warm_elapsed = 0.0;
+            const size_t w = cfg_.warmup_window;
+            for (;;) {
+                const double s = time_batch(k);
+                warm.push_back(s);
+                warm_elapsed += s;
+                if (warm.size() >= 2 * w) {
+                    std::vector<double> prev(warm.end() - 2 * w, warm.end() - w);
+                    std::vector<double> last(warm.end() - w, warm.end());
+                    const double mp = percentile(prev, 0.5);
+                    const double ml = percentile(last, 0.5);
+                    if (mp > 0.0 && std::fabs(ml - mp) / mp <= cfg_.warmup_tolerance) break;
+                }
+                if (warm_elapsed >= cfg_.max_warmup_time) break;
+            }
+            warmup_samples_ = warm.size();
+
+            // 3. Measurement (counters, when enabled, span exactly this phase)
+            std::unique_ptr<PerfCounterGroup> perf;
+            if (cfg_.perf) {
+                perf = std::make_unique<PerfCounterGroup>(cfg_.perf_events);
+                perf->start();
+            }
+            samples_.clear();
+            samples_.reserve(max_samples_);     // The harness itself must not allocate under the guard
+            double elapsed = 0.0;
+            {
+                std::unique_ptr<HotPathGuard> guard;
+                if (cfg_.alloc_check) guard = std::make_unique<HotPathGuard>();
+                measuring_ = true;
+                while (samples_.size() < max_samples_) {
+                    const double s = time_batch(k);
+                    samples_.push_back(s * 1e9 / static_cast<double>(k));
+                    elapsed += s;
+                    if (elapsed >= cfg_.max_time && samples_.size() >= 3) break;
+                }
+                measuring_ = false;
+                if (guard) allocations_ = guard->stats();
+            }
+            if (perf) {
+                perf->stop();
+                collect_counters(*perf, static_cast<double>(samples_.size() * k));
+            }
+        }
+
+        // Results (read by the runner)
+        const std::vector<double>& samples_ns() const { return samples_; }
+        size_t batch() const { return batch_; }
+        size_t warmup_samples() const { return warmup_samples_; }
+        double tsc_ghz() const { return tsc_ghz_; }
+        double items() const { return items_; }
+        double bytes() const { return bytes_; }
+        double flops() const { return flops_; }
+        const std::string& skip_reason() const { return skip_reason_; }
+        const std::string& error_message() const { return error_; }
+        const std::vector<CounterValue>& counters() const { return counters_; }
+        const std::string& perf_status() const { return perf_status_; }
+        const AllocStats& allocations() const { return allocations_; }
+
+    private:
+        void collect_counters(const PerfCounterGroup& perf, double iterations) {
+            counters_.clear();
+            perf_status_.clear();
+            for (size_t i = 0; i < perf.size(); ++i) {
+                if (perf.available(i)) {
+                    counters_.push_back({perf.event(i).name,
+                                         static_cast<double>(perf.totals()[i]) / iterations});
+                } else if (perf_status_.empty()) {
+                    perf_status_ = perf.event(i).name + ": " + perf.error(i);
+                }
+            }
+        }
+
+        static double percentile(std::vector<double> v, double q) {
+            std::sort(v.begin(), v.end());
+            return percentile_sorted(v, q);
+        }
+
+        const Config& cfg_;
+        size_t size_;
+        size_t max_samples_;
+        double items_ = 0.0;
+        double bytes_ = 0.0;
+        double flops_ = 0.0;
+        size_t batch_ = 0;
+        size_t warmup_samples_ = 0;
+        double tsc_ghz_ = 0.0;
+        bool measuring_ = false;
+        std::vector<double> samples_;
+        metrics::LatencyHistogram<> latency_;
+        std::vector<CounterValue> counters_;
+        std::string perf_status_;           // First counter that failed to open
+        AllocStats allocations_;
+        std::string skip_reason_;
+        std::string error_;
+    };
+
+    /**
+     * @brief A registered benchmark; builder methods chain off the macro.
+     */
+    class Benchmark {
+    public:
+        Benchmark(std::string name, std::function<void(State&)> fn)
+            : name_(std::move(name)), fn_(std::move(fn)) {}
+
+        /**
+         * @brief Runs one instance per size (State::size()).
+         */
+        Benchmark* sizes(std::initializer_list<size_t> values) {
+            sizes_.assign(values.begin(), values.end());
+            return this;
+        }
+
+        /**
+         * @brief Geometric size sweep: lo, lo*mult, ... <= hi.
+         */
+        Benchmark* range(size_t lo, size_t hi, size_t mult = 2) {
+            sizes_.clear();
+            for (size_t v = lo; v <= hi; v *= mult) {
+                sizes_.push_back(v);
+                if (mult < 2) break;
+            }
+            return this;
+        }
+
+        /**
+         * @brief Overrides Config::samples (useful for long-running operations).
+         */
+        Benchmark* samples(size_t n) {
+            samples_ = n;
+            return this;
+        }
+
+        /**
+         * @brief Declares op() allocation-free; enforced under --alloc-check.
+         */
+        Benchmark* no_alloc() {
+            no_alloc_ = true;
+            return this;
+        }
+
+        const std::string& name() const { return name_; }
+        const std::vector<size_t>& size_list() const { return sizes_; }
+        size_t sample_override() const { return samples_; }
+        bool requires_no_alloc() const { return no_alloc_; }
+        void invoke(State& state) const { fn_(state); }
+
+    private:
+        std::string name_;
+        std::function<void(State&)> fn_;
+        std::vector<size_t> sizes_;
+        size_t samples_ = 0;
+        bool no_alloc_ = false;
+    };
+
+    inline std::vector<std::unique_ptr<Benchmark>>& registry() {
+        static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+        return benchmarks;
+    }
+
+    inline Benchmark* register_benchmark(std::string name, std::function<void(State&)> fn) {
+        registry().push_back(std::make_unique<Benchmark>(std::move(name), std::move(fn)));
+        return registry().back().get();
+    }
+
+    /**
+     * @brief Result of one benchmark instance (name + size).
+     */
+    struct Result {
+        std::string name;
+        size_t size = 0;
+        size_t batch = 0;
+        size_t warmup_samples = 0;
+        double tsc_ghz = 0.0;           // TSC rate used for timing (0: steady_clock)
+        Summary ns_per_iter;
+        std::vector<double> samples_ns;     // Raw per-iteration samples (for baseline tests)
+        metrics::LatencyHistogram<> latency_ns;
+        double items = 0.0;
+        double bytes = 0.0;
+        double flops = 0.0;
+        std::vector<CounterValue> counters;
+        std::string perf_status;
+        AllocStats allocations;         // During measurement (with --alloc-check)
+        std::string skipped;
+        std::string error;
+    };
+
+    namespace detail {
+
+        inline std::string format_time(double ns) {
+            char buf[32];
+            if (ns < 1e3) {
+                std::snprintf(buf, sizeof(buf), "%.2f ns", ns);
+            } else if (ns < 1e6) {
+                std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+            } else if (ns < 1e9) {
+                std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+            } else {
+                std::snprintf(buf, sizeof(buf), "%.2f s", ns / 1e9);
+            }
+            return buf;
+        }
+
+        inline const CounterValue* find_counter(const Result& r, const char* name) {
+            for (const auto& c : r.counters) {
+                if (c.name == name) return &c;
+            }
+            return nullptr;
+        }
+
+        // IPC plus every counter per element of the size sweep (per iteration if unsized)
+        inline void print_counters(const Result& r) {
+            if (r.counters.empty()) {
+                if (!r.perf_status.empty()) std::printf("  perf: unavailable (%s)\n", r.perf_status.c_str());
+                return;
+            }
+            std::printf("  perf:");
+            const CounterValue* cycles = find_counter(r, "cycles");
+            const CounterValue* instructions = find_counter(r, "instructions");
+            if (cycles && instructions && cycles->per_iteration > 0.0) {
+                std::printf(" IPC %.2f", instructions->per_iteration / cycles->per_iteration);
+            }
+            const double div = r.size ? static_cast<double>(r.size) : 1.0;
+            const char* unit = r.size ? "elem" : "iter";
+            for (const auto& c : r.counters) {
+                std::printf("  %s %.4g/%s", c.name.c_str(), c.per_iteration / div, unit);
+            }
+            if (!r.perf_status.empty()) std::printf("  (n/a: %s)", r.perf_status.c_str());
+            std::printf("\n");
+        }
+
+        inline void print_result(const Result& r) {
+            std::string label = r.name;
+            if (r.size != 0) label += "/" + std::to_string(r.size);
+            if (!r.skipped.empty()) {
+                std::printf("%-44s SKIPPED (%s)\n", label.c_str(), r.skipped.c_str());
+                return;
+            }
+            const Summary& s = r.ns_per_iter;
+            std::printf("%-44s %12s  [%s, %s]  MAD %5.2f%%  p5 %s  p95 %s  p99 %s  n=%zu warmup=%zu",
+                        label.c_str(), format_time(s.median).c_str(),
+                        format_time(s.ci_low).c_str(), format_time(s.ci_high).c_str(),
+                        s.median > 0.0 ? 100.0 * s.mad / s.median : 0.0,
+                        format_time(s.p5).c_str(), format_time(s.p95).c_str(), format_time(s.p99).c_str(),
+                        s.count, r.warmup_samples);
+            if (s.outliers) std::printf(" outliers=%zu", s.outliers);
+            if (r.tsc_ghz > 0.0 && s.median * r.tsc_ghz < 1e6) {
+                std::printf("  %.1f ref-cycles", s.median * r.tsc_ghz);
+            }
+            if (r.bytes > 0.0) std::printf("  %.2f GB/s", r.bytes / s.median);
+            if (r.flops > 0.0) std::printf("  %.2f GFLOP/s", r.flops / s.median);
+            if (r.items > 0.0) std::printf("  %.2f M items/s", r.items * 1e3 / s.median);
+            std::printf("\n");
+            if (r.latency_ns.count() != 0) {
+                std::printf("  latency: ");
+                r.latency_ns.print(stdout, "ns");
+            }
+            print_counters(r);
+            if (r.allocations.allocations != 0) {
+                const double iterations = static_cast<double>(r.batch * s.count);
+                std::printf("  allocs: %llu (%.3g/iter, %llu bytes)\n",
+                            static_cast<unsigned long long>(r.allocations.allocations),
+                            iterations > 0.0 ? static_cast<double>(r.allocations.allocations) / iterations : 0.0,
+                            static_cast<unsigned long long>(r.allocations.bytes));
+            }
+            if (!r.error.empty()) std::printf("  [FAIL] %s\n", r.error.c_str());
+        }
+
+        inline bool parse_flag(const char* arg, const char* name, std::string& value) {
+            const size_t len = std::strlen(name);
+            if (std::strncmp(arg, name, len) == 0 && arg[len] == '=') {
+                value = arg + len + 1;
+                return true;
+            }
+            return false;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Runs every registered benchmark instance matching cfg.filter.
+     */
+    inline std::vector<Result> run_benchmarks(const Config& cfg) {
+        std::vector<Result> results;
+        if (cfg.alloc_check && !alloc_hooks_installed()) {
+            std::printf("alloc-check: allocator hooks not linked (define FWILLIAMSCA_ALLOC_GUARD_HOOKS in one TU)\n");
+        }
+        for (const auto& bm : registry()) {
+            std::vector<size_t> sizes = bm->size_list();
+            if (sizes.empty()) sizes.push_back(0);
+            for (size_t size : sizes) {
+                Result r;
+                r.name = bm->name();
+                r.size = size;
+                const std::string label = size ? r.name + "/" + std::to_string(size) : r.name;
+                if (!cfg.filter.empty() && label.find(cfg.filter) == std::string::npos) continue;
+
+                State state(cfg, size, bm->sample_override() ? bm->sample_override() : cfg.samples);
+                bm->invoke(state);
+                r.skipped = state.skip_reason();
+                r.error = state.error_message();
+                if (r.skipped.empty() && state.samples_ns().empty()) {
+                    r.skipped = "State::run() not called";
+                }
+                r.batch = state.batch();
+                r.warmup_samples = state.warmup_samples();
+                r.tsc_ghz = state.tsc_ghz();
+                r.ns_per_iter = summarize(state.samples_ns());
+                r.samples_ns = state.samples_ns();
+                r.latency_ns = state.latency();
+                r.items = state.items();
+                r.bytes = state.bytes();
+                r.flops = state.flops();
+                r.counters = state.counters();
+                r.perf_status = state.perf_status();
+                r.allocations = state.allocations();
+                if (bm->requires_no_alloc() && r.allocations.allocations != 0 && r.error.empty()) {
+                    r.error = std::to_string(r.allocations.allocations) + " allocations on a no_alloc() hot path";
+                }
+                detail::print_result(r);
+                std::fflush(stdout);
+                results.push_back(std::move(r));
+            }
+        }
+        return results;
+    }
+
+    /**
+     * @brief Parses --filter=, --samples=, --min-time= (s), --max-time= (s),
+     * --perf, --perf-raw=<hex>[,<hex>...] (extra raw PMU event codes,
+     * implies --perf) and --alloc-check into cfg. Unknown arguments are returned for the caller.
+     */
+    inline std::vector<std::string> parse_args(int argc, char** argv, Config& cfg) {
+        std::vector<std::string> rest;
+        for (int i = 1; i < argc; ++i) {
+            std::string v;
+            if (detail::parse_flag(argv[i], "--filter", v)) {
+                cfg.filter = v;
+            } else if (detail::parse_flag(argv[i], "--samples", v)) {
+                cfg.samples = std::strtoul(v.c_str(), nullptr, 10);
+            } else if (detail::parse_flag(argv[i], "--min-time", v)) {
+                cfg.min_sample_time = std::strtod(v.c_str(), nullptr);
+            } else if (detail::parse_flag(argv[i], "--max-time", v)) {
+                cfg.max_time = std::strtod(v.c_str(), nullptr);
+            } else if (std::strcmp(argv[i], "--perf") == 0) {
+                cfg.perf = true;
+            } else if (std::strcmp(argv[i], "--alloc-check") == 0) {
+                cfg.alloc_check = true;
+            } else if (detail::parse_flag(argv[i], "--perf-raw", v)) {
+                cfg.perf = true;
+                size_t pos = 0;
+                while (pos < v.size()) {
+                    size_t end = v.find(',', pos);
+                    if (end == std::string::npos) end = v.size();
+                    const std::string code = v.substr(pos, end - pos);
+                    cfg.perf_events.push_back(raw_event("r" + code, std::strtoull(code.c_str(), nullptr, 16)));
+                    pos = end + 1;
+                }
+            } else {
+                rest.emplace_back(argv[i]);
+            }
+        }
+        return rest;
+    }
+
+    /**
+     * @brief Entry point: parse flags, run, return non-zero on any [FAIL].
+     */
+    inline int run_all(int argc, char** argv) {
+        Config cfg;
+        for (const auto& unknown : parse_args(argc, argv, cfg)) {
+            std::fprintf(stderr, "Unknown argument: %s\n", unknown.c_str());
+            return 2;
+        }
+        int status = 0;
+        for (const auto& r : run_benchmarks(cfg)) {
+            if (!r.error.empty()) status = 1;
+        }
+        return status;
+    }
+
+} // namespace bench
+} // namespace fwilliamsca
+
+#define FWILLIAMSCA_BENCH_CONCAT_(a, b) a##b
+#define FWILLIAMSCA_BENCH_CONCAT(a, b) FWILLIAMSCA_BENCH_CONCAT_(a, b)
+
+/**
+ * @brief Registers void fn(bench::State&); chain builder calls with ->.
+ */
+#define FWILLIAMSCA_BENCHMARK(fn)                                                        \
+    [[maybe_unused]] static ::fwilliamsca::bench::Benchmark*                            \
+        FWILLIAMSCA_BENCH_CONCAT(fwilliamsca_bench_, __LINE__) =                         \
+            ::fwilliamsca::bench::register_benchmark(#fn, fn)
+
+/**
+ * @brief Registers a template instantiation, e.g. fn<simd::ISA::AVX2>.
+ * The template argument becomes part of the benchmark name.
+ */
+#define FWILLIAMSCA_BENCHMARK_TEMPLATE(fn, ...)                                          \
+    [[maybe_unused]] static ::fwilliamsca::bench::Benchmark*                            \
+        FWILLIAMSCA_BENCH_CONCAT(fwilliamsca_bench_, __LINE__) =                         \
+            ::fwilliamsca::bench::register_benchmark(#fn "<" #__VA_ARGS__ ">", fn<__VA_ARGS__>)
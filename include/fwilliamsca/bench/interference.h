@@ -0,0 +1,207 @@
+/**
+ * @file interference.h
+ * @brief Noisy-neighbour load generators for tail-latency experiments.
+ * * Means hide the problem; p99.99 spikes come from what else runs on the
+ * box. Each Interferer reproduces one class of neighbour on a set of cores:
+ * - MemoryBandwidth: streaming copies that saturate the memory controller.
+ * - LlcThrasher:     strided read-modify-writes over 2x the LLC, evicting
+ *                    everyone else's lines.
+ * - Avx512:          dense 512-bit FMA loops (power/frequency license).
+ * - SyscallStorm:    cheap syscalls plus mmap/munmap churn, which costs
+ *                    TLB-shootdown IPIs on the other cores of the process.
+ *
+ * Usage:
+ *   bench::InterferenceGroup noise(bench::Interferer::LlcThrasher, {2, 3});
+ *   ... measure ...        // threads stop when noise goes out of scope
+ */
+
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../concurrency/affinity.h"
+#include "../concurrency/topology.h"
+
+namespace fwilliamsca {
+namespace bench {
+
+    enum class Interferer {
+        None,
+        MemoryBandwidth,
+        LlcThrasher,
+        Avx512,
+        SyscallStorm
+    };
+
+    inline const char* to_string(Interferer kind) {
+        switch (kind) {
+            case Interferer::None:            return "none";
+            case Interferer::MemoryBandwidth: return "memory-bw";
+            case Interferer::LlcThrasher:     return "llc-thrash";
+            case Interferer::Avx512:          return "avx512";
+            case Interferer::SyscallStorm:    return "syscall";
+        }
+        return "?";
+    }
+
+    /**
+     * @brief Parses the to_string() names (returns false if unknown).
+     */
+    inline bool parse_interferer(const std::string& name, Interferer& out) {
+        for (Interferer k : {Interferer::None, Interferer::MemoryBandwidth, Interferer::LlcThrasher,
+                             Interferer::Avx512, Interferer::SyscallStorm}) {
+            if (name == to_string(k)) {
+                out = k;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief True if this host can run the interferer (AVX-512 needs the ISA).
+     */
+    inline bool interferer_supported(Interferer kind) {
+        if (kind != Interferer::Avx512) return true;
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f");
+    }
+
+    namespace detail {
+
+        inline void memory_bandwidth_loop(const std::atomic<bool>& stop) {
+            constexpr size_t Bytes = size_t(64) << 20;
+            std::unique_ptr<char[]> src(new char[Bytes]);
+            std::unique_ptr<char[]> dst(new char[Bytes]);
+            std::memset(src.get(), 1, Bytes);
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (size_t off = 0; off < Bytes && !stop.load(std::memory_order_relaxed); off += size_t(1) << 20) {
+                    std::memcpy(dst.get() + off, src.get() + off, size_t(1) << 20);
+                }
+            }
+        }
+
+        inline void llc_thrash_loop(const std::atomic<bool>& stop) {
+            size_t llc = size_t(32) << 20;
+            const auto caches = concurrency::data_cache_levels();
+            if (!caches.empty()) llc = caches.back().size;
+            // Prime stride in lines: no spatial locality for the prefetcher to exploit
+            constexpr size_t stride = 4099;
+            // Capped so a VM reporting a huge shared LLC doesn't eat the host's RAM; the
+            // 1 MiB floor (16384 lines) keeps stride < lines, so one subtraction wraps idx
+            constexpr size_t min_bytes = size_t(1) << 20;
+            static_assert(stride < min_bytes / 64, "llc_thrash_loop stride must be below the minimum line count.");
+            const size_t bytes = std::clamp(2 * llc, min_bytes, size_t(512) << 20);
+            const size_t lines = bytes / 64;
+            std::unique_ptr<uint64_t[]> buf(new uint64_t[lines * 8]());
+            size_t idx = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (size_t k = 0; k < 4096; ++k) {
+                    buf[idx * 8] += 1;
+                    idx += stride;
+                    if (idx >= lines) idx -= lines;
+                }
+            }
+        }
+
+        __attribute__((target("avx512f"))) inline void avx512_loop(const std::atomic<bool>& stop) {
+            __m512d a = _mm512_set1_pd(1.0000001);
+            __m512d b = _mm512_set1_pd(0.9999999);
+            __m512d c0 = _mm512_setzero_pd(), c1 = c0, c2 = c0, c3 = c0, c4 = c0, c5 = c0, c6 = c0, c7 = c0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int k = 0; k < 1024; ++k) {
+                    c0 = _mm512_fmadd_pd(a, b, c0);
+                    c1 = _mm512_fmadd_pd(a, b, c1);
+                    c2 = _mm512_fmadd_pd(a, b, c2);
+                    c3 = _mm512_fmadd_pd(a, b, c3);
+                    c4 = _mm512_fmadd_pd(a, b, c4);
+                    c5 = _mm512_fmadd_pd(a, b, c5);
+                    c6 = _mm512_fmadd_pd(a, b, c6);
+                    c7 = _mm512_fmadd_pd(a, b, c7);
+                }
+            }
+            // Keep the accumulators live
+            volatile double sink = _mm512_cvtsd_f64(
+                _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(c0, c1), _mm512_add_pd(c2, c3)),
+                              _mm512_add_pd(_mm512_add_pd(c4, c5), _mm512_add_pd(c6, c7))));
+            (void)sink;
+        }
+
+        inline void syscall_storm_loop(const std::atomic<bool>& stop) {
+            const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int k = 0; k < 64; ++k) {
+                    syscall(SYS_getppid);
+                    timespec ts;
+                    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);   // Not served by the vDSO
+                }
+                void* p = mmap(nullptr, page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (p != MAP_FAILED) {
+                    static_cast<char*>(p)[0] = 1;
+                    munmap(p, page);
+                }
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief One interferer thread per listed core (pinned; cores < 0 leave
+     * a thread unpinned). Threads run from construction until stop().
+     */
+    class InterferenceGroup {
+    public:
+        InterferenceGroup(Interferer kind, const std::vector<int>& cores) : kind_(kind) {
+            if (kind == Interferer::None || !interferer_supported(kind)) return;
+            for (int core : cores) {
+                threads_.emplace_back([this, core]() {
+                    concurrency::name_current_thread(to_string(kind_));
+                    if (core >= 0) concurrency::pin_current_thread(core);
+                    switch (kind_) {
+                        case Interferer::MemoryBandwidth: detail::memory_bandwidth_loop(stop_); break;
+                        case Interferer::LlcThrasher:     detail::llc_thrash_loop(stop_); break;
+                        case Interferer::Avx512:          detail::avx512_loop(stop_); break;
+                        case Interferer::SyscallStorm:    detail::syscall_storm_loop(stop_); break;
+                        case Interferer::None:            break;
+                    }
+                });
+            }
+        }
+
+        ~InterferenceGroup() { stop(); }
+
+        InterferenceGroup(const InterferenceGroup&) = delete;
+        InterferenceGroup& operator=(const InterferenceGroup&) = delete;
+
+        void stop() {
+            stop_.store(true, std::memory_order_relaxed);
+            for (auto& t : threads_) {
+                if (t.joinable()) t.join();
+            }
+        }
+
+        Interferer kind() const { return kind_; }
+        size_t threads() const { return threads_.size(); }
+
+    private:
+        Interferer kind_;
+        std::atomic<bool> stop_{false};
+        std::vector<std::thread> threads_;
+    };
+
+} // namespace bench
+} // namespace fwilliamsca
@@ -0,0 +1,613 @@
+/**
+ * @file report.h
+ * @brief Machine-readable benchmark output (JSON/CSV) and baseline comparison.
+ * * A run can be written as JSON (host metadata + every result with its raw
+ * samples) and/or CSV (one row per result). A saved JSON file can later be
+ * loaded as a baseline: each matching instance (name + size) is tested with
+ * a one-sided Mann-Whitney U test, and it counts as a regression only if
+ * the slowdown is both significant (p < alpha) and larger than a relative
+ * threshold. report_results() returns ExitRegression when any is found, so
+ * a CI job can gate on it:
+ *
+ *   ./bench --json=base.json                      # on the reference commit
+ *   ./bench --baseline=base.json --json=new.json  # on the candidate
+ */
+
+#pragma once
+
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "harness.h"
+#include "../detail/json.h"
+
+namespace fwilliamsca {
+namespace bench {
+
+    constexpr int ExitRegression = 3;
+
+    struct ReportConfig {
+        std::string json_path;
+        std::string csv_path;
+        std::string baseline_path;
+        double threshold = 0.05;    // Minimum relative slowdown that can fail the run
+        double alpha = 0.01;        // Significance level of the U test
+    };
+
+    struct HostInfo {
+        std::string cpu_model;
+        unsigned logical_cpus = 0;
+        std::string governor;       // cpufreq scaling governor of cpu0 ("n/a" if absent)
+        double tsc_ghz = 0.0;
+        std::string compiler;
+        std::string build_flags;    // FWILLIAMSCA_BUILD_FLAGS if defined, else detected target features
+        std::string compiled_isa;   // Widest SIMD level the compiler targeted
+        std::string host_isa;       // SIMD levels the CPU supports
+        std::string kernel;
+        std::string hostname;
+        std::string timestamp;      // UTC, ISO 8601
+    };
+
+    namespace detail {
+
+        inline std::string read_line(const char* path) {
+            std::FILE* f = std::fopen(path, "r");
+            if (!f) return "";
+            char buf[256] = {};
+            const bool ok = std::fgets(buf, sizeof(buf), f) != nullptr;
+            std::fclose(f);
+            if (!ok) return "";
+            std::string s(buf);
+            while (!s.empty() && (s.back() == '\n' || s.back() == '\r')) s.pop_back();
+            return s;
+        }
+
+        inline std::string cpu_model_name() {
+            std::FILE* f = std::fopen("/proc/cpuinfo", "r");
+            if (!f) return "unknown";
+            char line[512];
+            std::string model = "unknown";
+            while (std::fgets(line, sizeof(line), f)) {
+                if (std::strncmp(line, "model name", 10) == 0) {
+                    const char* colon = std::strchr(line, ':');
+                    if (colon) {
+                        model = colon + 1;
+                        while (!model.empty() && (model.front() == ' ' || model.front() == '\t')) model.erase(0, 1);
+                        while (!model.empty() && model.back() == '\n') model.pop_back();
+                    }
+                    break;
+                }
+            }
+            std::fclose(f);
+            return model;
+        }
+
+        inline std::string csv_escape(const std::string& s) {
+            if (s.find_first_of(",\"\n") == std::string::npos) return s;
+            std::string out = "\"";
+            for (char c : s) {
+                if (c == '"') out += '"';
+                out += c;
+            }
+            return out + "\"";
+        }
+
+        /**
+         * @brief Minimal JSON DOM, enough to read back files written by write_json().
+         */
+        struct JsonValue {
+            enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+            bool boolean = false;
+            double number = 0.0;
+            std::string string;
+            std::vector<JsonValue> array;
+            std::vector<std::pair<std::string, JsonValue>> object;
+
+            const JsonValue* get(const char* key) const {
+                for (const auto& kv : object) {
+                    if (kv.first == key) return &kv.second;
+                }
+                return nullptr;
+            }
+        };
+
+        class JsonParser {
+        public:
+            explicit JsonParser(const std::string& text) : s_(text) {}
+
+            bool parse(JsonValue& out) {
+                if (!value(out)) return false;
+                skip_ws();
+                return pos_ == s_.size();
+            }
+
+        private:
+            void skip_ws() {
+                while (pos_ < s_.size() && (s_[pos_] == ' ' || s_[pos_] == '\n' || s_[pos_] == '\r' || s_[pos_] == '\t')) {
+                    ++pos_;
+                }
+            }
+
+            bool literal(const char* word) {
+                const size_t len = std::strlen(word);
+                if (s_.compare(pos_, len, word) != 0) return false;
+                pos_ += len;
+                return true;
+            }
+
+            bool string(std::string& out) {
+                if (s_[pos_] != '"') return false;
+                ++pos_;
+                while (pos_ < s_.size() && s_[pos_] != '"') {
+                    char c = s_[pos_++];
+                    if (c == '\\') {
+                        if (pos_ >= s_.size()) return false;
+                        const char e = s_[pos_++];
+                        switch (e) {
+                            case 'n': c = '\n'; break;
+                            case 't': c = '\t'; break;
+                            case 'r': c = '\r'; break;
+                            case 'u':
+                                if (pos_ + 4 > s_.size()) return false;
+                                c = static_cast<char>(std::strtol(s_.substr(pos_, 4).c_str(), nullptr, 16));
+                                pos_ += 4;
+                                break;
+                            default: c = e;
+                        }
+                    }
+                    out += c;
+                }
+                if (pos_ >= s_.size()) return false;
+                ++pos_;
+                return true;
+            }
+
+            bool value(JsonValue& v) {
+                skip_ws();
+                if (pos_ >= s_.size()) return false;
+                const char c = s_[pos_];
+                if (c == '{') {
+                    v.type = JsonValue::Type::Object;
+                    ++pos_;
+                    skip_ws();
+                    if (pos_ < s_.size() && s_[pos_] == '}') { ++pos_; return true; }
+                    for (;;) {
+                        skip_ws();
+                        std::string key;
+                        if (pos_ >= s_.size() || !string(key)) return false;
+                        skip_ws();
+                        if (pos_ >= s_.size() || s_[pos_++] != ':') return false;
+                        JsonValue member;
+                        if (!value(member)) return false;
+                        v.object.emplace_back(std::move(key), std::move(member));
+                        skip_ws();
+                        if (pos_ >= s_.size()) return false;
+                        if (s_[pos_] == ',') { ++pos_; continue; }
+                        if (s_[pos_] == '}') { ++pos_; return true; }
+                        return false;
+                    }
+                }
+                if (c == '[') {
+                    v.type = JsonValue::Type::Array;
+                    ++pos_;
+                    skip_ws();
+                    if (pos_ < s_.size() && s_[pos_] == ']') { ++pos_; return true; }
+                    for (;;) {
+                        JsonValue element;
+                        if (!value(element)) return false;
+                        v.array.push_back(std::move(element));
+                        skip_ws();
+                        if (pos_ >= s_.size()) return false;
+                        if (s_[pos_] == ',') { ++pos_; continue; }
+                        if (s_[pos_] == ']') { ++pos_; return true; }
+                        return false;
+                    }
+                }
+                if (c == '"') {
+                    v.type = JsonValue::Type::String;
+                    return string(v.string);
+                }
+                if (literal("true")) { v.type = JsonValue::Type::Bool; v.boolean = true; return true; }
+                if (literal("false")) { v.type = JsonValue::Type::Bool; return true; }
+                if (literal("null")) { v.type = JsonValue::Type::Null; return true; }
+
+                char* end = nullptr;
+                v.number = std::strtod(s_.c_str() + pos_, &end);
+                if (end == s_.c_str() + pos_) return false;
+                v.type = JsonValue::Type::Number;
+                pos_ = static_cast<size_t>(end - s_.c_str());
+                return true;
+            }
+
+            const std::string& s_;
+            size_t pos_ = 0;
+        };
+
+        inline double number_or(const JsonValue& obj, const char* key, double fallback) {
+            const JsonValue* v = obj.get(key);
+            return v && v->type == JsonValue::Type::Number ? v->number : fallback;
+        }
+
+        inline std::string string_or(const JsonValue& obj, const char* key, const std::string& fallback) {
+            const JsonValue* v = obj.get(key);
+            return v && v->type == JsonValue::Type::String ? v->string : fallback;
+        }
+
+        inline std::string label(const std::string& name, size_t size) {
+            return size ? name + "/" + std::to_string(size) : name;
+        }
+
+    } // namespace detail
+
+    inline HostInfo collect_host_info() {
+        HostInfo h;
+        h.cpu_model = detail::cpu_model_name();
+        const long n = sysconf(_SC_NPROCESSORS_ONLN);
+        h.logical_cpus = n > 0 ? static_cast<unsigned>(n) : 0;
+        h.governor = detail::read_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+        if (h.governor.empty()) h.governor = "n/a";
+        h.tsc_ghz = timing::TscClock::instance().ghz();
+
+#if defined(__clang__)
+        h.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+        h.compiler = "gcc " __VERSION__;
+#else
+        h.compiler = "unknown";
+#endif
+
+#if defined(FWILLIAMSCA_BUILD_FLAGS)
+        h.build_flags = FWILLIAMSCA_BUILD_FLAGS;
+#else
+#if defined(__OPTIMIZE__)
+        h.build_flags += "optimize ";
+#endif
+#if defined(__SSE4_2__)
+        h.build_flags += "sse4.2 ";
+#endif
+#if defined(__AVX2__)
+        h.build_flags += "avx2 ";
+#endif
+#if defined(__FMA__)
+        h.build_flags += "fma ";
+#endif
+#if defined(__AVX512F__)
+        h.build_flags += "avx512f ";
+#endif
+#if defined(__AVX512BW__)
+        h.build_flags += "avx512bw ";
+#endif
+#if defined(__AVX512VL__)
+        h.build_flags += "avx512vl ";
+#endif
+        if (!h.build_flags.empty()) h.build_flags.pop_back();
+#endif
+
+#if defined(__AVX512F__)
+        h.compiled_isa = "AVX512_F";
+#elif defined(__AVX2__)
+        h.compiled_isa = "AVX2";
+#else
+        h.compiled_isa = "Scalar";
+#endif
+        __builtin_cpu_init();
+        h.host_isa = "Scalar";
+        if (__builtin_cpu_supports("sse4.2")) h.host_isa += " SSE4_2";
+        if (__builtin_cpu_supports("avx2")) h.host_isa += " AVX2";
+        if (__builtin_cpu_supports("avx512f")) h.host_isa += " AVX512_F";
+        if (__builtin_cpu_supports("avx512bw")) h.host_isa += " AVX512_BW";
+
+        utsname u;
+        if (uname(&u) == 0) {
+            h.kernel = std::string(u.sysname) + " " + u.release;
+            h.hostname = u.nodename;
+        }
+
+        char ts[32];
+        const std::time_t now = std::time(nullptr);
+        std::tm tm;
+        gmtime_r(&now, &tm);
+        std::strftime(ts, sizeof(ts), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        h.timestamp = ts;
+        return h;
+    }
+
+    inline bool write_json(const std::string& path, const HostInfo& host, const std::vector<Result>& results) {
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) return false;
+        using fwilliamsca::detail::json_escape;
+        using fwilliamsca::detail::json_number;
+        std::fprintf(f, "{\n  \"host\": {\n");
+        std::fprintf(f, "    \"cpu_model\": \"%s\",\n", json_escape(host.cpu_model).c_str());
+        std::fprintf(f, "    \"logical_cpus\": %u,\n", host.logical_cpus);
+        std::fprintf(f, "    \"governor\": \"%s\",\n", json_escape(host.governor).c_str());
+        std::fprintf(f, "    \"tsc_ghz\": %.6f,\n", host.tsc_ghz);
+        std::fprintf(f, "    \"compiler\": \"%s\",\n", json_escape(host.compiler).c_str());
+        std::fprintf(f, "    \"build_flags\": \"%s\",\n", json_escape(host.build_flags).c_str());
+        std::fprintf(f, "    \"compiled_isa\": \"%s\",\n", json_escape(host.compiled_isa).c_str());
+        std::fprintf(f, "    \"host_isa\": \"%s\",\n", json_escape(host.host_isa).c_str());
+        std::fprintf(f, "    \"kernel\": \"%s\",\n", json_escape(host.kernel).c_str());
+        std::fprintf(f, "    \"hostname\": \"%s\",\n", json_escape(host.hostname).c_str());
+        std::fprintf(f, "    \"timestamp\": \"%s\"\n  },\n", json_escape(host.timestamp).c_str());
+        std::fprintf(f, "  \"results\": [");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            const Summary& s = r.ns_per_iter;
+            std::fprintf(f, "%s\n    {\"name\": \"%s\", \"size\": %zu", i ? "," : "", json_escape(r.name).c_str(), r.size);
+            if (!r.skipped.empty()) {
+                std::fprintf(f, ", \"skipped\": \"%s\"}", json_escape(r.skipped).c_str());
+                continue;
+            }
+            std::fprintf(f, ", \"batch\": %zu, \"median_ns\": %s, \"mean_ns\": %s, \"stddev_ns\": %s"
+                            ", \"mad_ns\": %s, \"min_ns\": %s, \"max_ns\": %s, \"p5_ns\": %s, \"p95_ns\": %s"
+                            ", \"p99_ns\": %s, \"ci_low_ns\": %s, \"ci_high_ns\": %s",
+                         r.batch, json_number(s.median).c_str(), json_number(s.mean).c_str(),
+                         json_number(s.stddev).c_str(), json_number(s.mad).c_str(), json_number(s.min).c_str(),
+                         json_number(s.max).c_str(), json_number(s.p5).c_str(), json_number(s.p95).c_str(),
+                         json_number(s.p99).c_str(), json_number(s.ci_low).c_str(), json_number(s.ci_high).c_str());
+            if (r.bytes > 0.0 && s.median > 0.0) {
+                std::fprintf(f, ", \"gb_per_s\": %s", json_number(r.bytes / s.median).c_str());
+            }
+            if (r.flops > 0.0 && s.median > 0.0) {
+                std::fprintf(f, ", \"gflop_per_s\": %s", json_number(r.flops / s.median).c_str());
+            }
+            if (r.items > 0.0 && s.median > 0.0) {
+                std::fprintf(f, ", \"mitems_per_s\": %s", json_number(r.items * 1e3 / s.median).c_str());
+            }
+            if (r.latency_ns.count() != 0) {
+                std::fprintf(f, ", \"latency_ns\": {\"p50\": %llu, \"p99\": %llu, \"p99.9\": %llu, \"max\": %llu}",
+                             static_cast<unsigned long long>(r.latency_ns.value_at_percentile(50.0)),
+                             static_cast<unsigned long long>(r.latency_ns.value_at_percentile(99.0)),
+                             static_cast<unsigned long long>(r.latency_ns.value_at_percentile(99.9)),
+                             static_cast<unsigned long long>(r.latency_ns.max()));
+            }
+            if (!r.counters.empty()) {
+                std::fprintf(f, ", \"counters_per_iter\": {");
+                for (size_t c = 0; c < r.counters.size(); ++c) {
+                    std::fprintf(f, "%s\"%s\": %s", c ? ", " : "", json_escape(r.counters[c].name).c_str(),
+                                 json_number(r.counters[c].per_iteration).c_str());
+                }
+                std::fprintf(f, "}");
+            }
+            if (!r.error.empty()) std::fprintf(f, ", \"error\": \"%s\"", json_escape(r.error).c_str());
+            std::fprintf(f, ", \"samples_ns\": [");
+            for (size_t k = 0; k < r.samples_ns.size(); ++k) {
+                std::fprintf(f, "%s%s", k ? ", " : "", json_number(r.samples_ns[k]).c_str());
+            }
+            std::fprintf(f, "]}");
+        }
+        std::fprintf(f, "\n  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+
+    /**
+     * @brief One row per result; host metadata as leading "# key: value" lines.
+     */
+    inline bool write_csv(const std::string& path, const HostInfo& host, const std::vector<Result>& results) {
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) return false;
+        std::fprintf(f, "# cpu_model: %s\n# logical_cpus: %u\n# governor: %s\n# tsc_ghz: %.6f\n",
+                     host.cpu_model.c_str(), host.logical_cpus, host.governor.c_str(), host.tsc_ghz);
+        std::fprintf(f, "# compiler: %s\n# build_flags: %s\n# compiled_isa: %s\n# host_isa: %s\n",
+                     host.compiler.c_str(), host.build_flags.c_str(), host.compiled_isa.c_str(), host.host_isa.c_str());
+        std::fprintf(f, "# kernel: %s\n# hostname: %s\n# timestamp: %s\n",
+                     host.kernel.c_str(), host.hostname.c_str(), host.timestamp.c_str());
+        std::fprintf(f, "name,size,samples,median_ns,mean_ns,stddev_ns,mad_ns,p5_ns,p95_ns,p99_ns,ci_low_ns,ci_high_ns,"
+                        "gb_per_s,gflop_per_s,mitems_per_s,skipped,error\n");
+        for (const Result& r : results) {
+            const Summary& s = r.ns_per_iter;
+            std::fprintf(f, "%s,%zu,%zu,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%s,%s\n",
+                         detail::csv_escape(r.name).c_str(), r.size, s.count, s.median, s.mean, s.stddev, s.mad,
+                         s.p5, s.p95, s.p99, s.ci_low, s.ci_high,
+                         r.bytes > 0.0 && s.median > 0.0 ? r.bytes / s.median : 0.0,
+                         r.flops > 0.0 && s.median > 0.0 ? r.flops / s.median : 0.0,
+                         r.items > 0.0 && s.median > 0.0 ? r.items * 1e3 / s.median : 0.0,
+                         detail::csv_escape(r.skipped).c_str(), detail::csv_escape(r.error).c_str());
+        }
+        return std::fclose(f) == 0;
+    }
+
+    struct BaselineEntry {
+        std::string name;
+        size_t size = 0;
+        double median_ns = 0.0;
+        double ci_low_ns = 0.0;
+        double ci_high_ns = 0.0;
+        std::vector<double> samples_ns;
+    };
+
+    /**
+     * @brief Loads the results of a write_json() file (skipped entries omitted).
+     * @return false if the file is missing or malformed.
+     */
+    inline bool load_baseline(const std::string& path, std::vector<BaselineEntry>& out, HostInfo* host = nullptr) {
+        std::FILE* f = std::fopen(path.c_str(), "r");
+        if (!f) return false;
+        std::string text;
+        char buf[4096];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+        std::fclose(f);
+
+        detail::JsonValue root;
+        if (!detail::JsonParser(text).parse(root) || root.type != detail::JsonValue::Type::Object) return false;
+        const detail::JsonValue* results = root.get("results");
+        if (!results || results->type != detail::JsonValue::Type::Array) return false;
+
+        if (host) {
+            if (const detail::JsonValue* h = root.get("host")) {
+                host->cpu_model = detail::string_or(*h, "cpu_model", "");
+                host->compiler = detail::string_or(*h, "compiler", "");
+                host->build_flags = detail::string_or(*h, "build_flags", "");
+                host->governor = detail::string_or(*h, "governor", "");
+                host->timestamp = detail::string_or(*h, "timestamp", "");
+            }
+        }
+
+        out.clear();
+        for (const auto& r : results->array) {
+            if (r.get("skipped")) continue;
+            BaselineEntry e;
+            e.name = detail::string_or(r, "name", "");
+            e.size = static_cast<size_t>(detail::number_or(r, "size", 0.0));
+            e.median_ns = detail::number_or(r, "median_ns", 0.0);
+            e.ci_low_ns = detail::number_or(r, "ci_low_ns", e.median_ns);
+            e.ci_high_ns = detail::number_or(r, "ci_high_ns", e.median_ns);
+            if (const detail::JsonValue* s = r.get("samples_ns")) {
+                for (const auto& v : s->array) {
+                    if (v.type == detail::JsonValue::Type::Number) e.samples_ns.push_back(v.number);
+                }
+            }
+            if (!e.name.empty() && e.median_ns > 0.0) out.push_back(std::move(e));
+        }
+        return true;
+    }
+
+    struct Comparison {
+        std::string name;
+        size_t size = 0;
+        double baseline_ns = 0.0;
+        double current_ns = 0.0;
+        double change = 0.0;        // Relative change of the median (+ = slower)
+        double p_slower = 1.0;      // One-sided p-value for "current is slower"
+        double p_faster = 1.0;
+        bool rank_test = false;     // Decided by Mann-Whitney; else by median CI overlap
+        bool regression = false;
+        bool improvement = false;
+    };
+
+    /**
+     * @brief Matches results to baseline entries by name + size. Without
+     * MannWhitneyMinSamples raw samples on both sides, non-overlapping median
+     * CIs stand in for the test: at 3-4 samples per side its smallest
+     * attainable p-value is above any useful alpha, so it could never flag.
+     */
+    inline std::vector<Comparison> compare_to_baseline(const std::vector<BaselineEntry>& baseline,
+                                                       const std::vector<Result>& results,
+                                                       double threshold, double alpha) {
+        std::vector<Comparison> out;
+        for (const Result& r : results) {
+            if (!r.skipped.empty() || r.ns_per_iter.median <= 0.0) continue;
+            for (const BaselineEntry& b : baseline) {
+                if (b.name != r.name || b.size != r.size) continue;
+                Comparison c;
+                c.name = r.name;
+                c.size = r.size;
+                c.baseline_ns = b.median_ns;
+                c.current_ns = r.ns_per_iter.median;
+                c.change = c.current_ns / c.baseline_ns - 1.0;
+                bool slower, faster;
+                c.rank_test = b.samples_ns.size() >= MannWhitneyMinSamples &&
+                              r.samples_ns.size() >= MannWhitneyMinSamples;
+                if (c.rank_test) {
+                    c.p_slower = mann_whitney_greater(b.samples_ns, r.samples_ns);
+                    c.p_faster = mann_whitney_greater(r.samples_ns, b.samples_ns);
+                    slower = c.p_slower < alpha;
+                    faster = c.p_faster < alpha;
+                } else {
+                    slower = r.ns_per_iter.ci_low > b.ci_high_ns;
+                    faster = r.ns_per_iter.ci_high < b.ci_low_ns;
+                }
+                c.regression = slower && c.change > threshold;
+                c.improvement = faster && c.change < -threshold;
+                out.push_back(c);
+                break;
+            }
+        }
+        return out;
+    }
+
+    inline void print_comparison(const std::vector<Comparison>& comparisons, double threshold, double alpha) {
+        std::printf("\nBaseline comparison (threshold %.1f%%, alpha %.3g)\n", 100.0 * threshold, alpha);
+        size_t regressions = 0;
+        size_t improvements = 0;
+        for (const Comparison& c : comparisons) {
+            const char* verdict = c.regression ? "REGRESSION" : c.improvement ? "improved" : "";
+            char test[32];
+            if (c.rank_test) {
+                std::snprintf(test, sizeof(test), "p=%.2g", c.change >= 0.0 ? c.p_slower : c.p_faster);
+            } else {
+                std::snprintf(test, sizeof(test), "CI");
+            }
+            std::printf("%-44s %12s -> %12s  %+7.2f%%  %-8s %s\n", detail::label(c.name, c.size).c_str(),
+                        detail::format_time(c.baseline_ns).c_str(), detail::format_time(c.current_ns).c_str(),
+                        100.0 * c.change, test, verdict);
+            regressions += c.regression;
+            improvements += c.improvement;
+        }
+        std::printf("%zu compared, %zu regressions, %zu improvements\n", comparisons.size(), regressions, improvements);
+    }
+
+    /**
+     * @brief Consumes --json=, --csv=, --baseline=, --threshold= (fraction)
+     * and --alpha= from args; anything else is left in place.
+     */
+    inline void parse_report_args(std::vector<std::string>& args, ReportConfig& cfg) {
+        std::vector<std::string> rest;
+        for (const auto& arg : args) {
+            std::string v;
+            if (detail::parse_flag(arg.c_str(), "--json", v)) {
+                cfg.json_path = v;
+            } else if (detail::parse_flag(arg.c_str(), "--csv", v)) {
+                cfg.csv_path = v;
+            } else if (detail::parse_flag(arg.c_str(), "--baseline", v)) {
+                cfg.baseline_path = v;
+            } else if (detail::parse_flag(arg.c_str(), "--threshold", v)) {
+                cfg.threshold = std::strtod(v.c_str(), nullptr);
+            } else if (detail::parse_flag(arg.c_str(), "--alpha", v)) {
+                cfg.alpha = std::strtod(v.c_str(), nullptr);
+            } else {
+                rest.push_back(arg);
+            }
+        }
+        args = std::move(rest);
+    }
+
+    /**
+     * @brief Writes the requested outputs and compares against the baseline.
+     * @return 0, 2 if an output or the baseline could not be used, or
+     * ExitRegression if any instance regressed.
+     */
+    inline int report_results(const ReportConfig& cfg, const std::vector<Result>& results) {
+        const HostInfo host = collect_host_info();
+        int status = 0;
+        if (!cfg.json_path.empty() && !write_json(cfg.json_path, host, results)) {
+            std::fprintf(stderr, "Cannot write %s\n", cfg.json_path.c_str());
+            status = 2;
+        }
+        if (!cfg.csv_path.empty() && !write_csv(cfg.csv_path, host, results)) {
+            std::fprintf(stderr, "Cannot write %s\n", cfg.csv_path.c_str());
+            status = 2;
+        }
+        if (!cfg.baseline_path.empty()) {
+            std::vector<BaselineEntry> baseline;
+            HostInfo base_host;
+            if (!load_baseline(cfg.baseline_path, baseline, &base_host)) {
+                std::fprintf(stderr, "Cannot load baseline %s\n", cfg.baseline_path.c_str());
+                return 2;
+            }
+            if (base_host.cpu_model != host.cpu_model || base_host.compiler != host.compiler) {
+                std::printf("\nNote: baseline was recorded on '%s' with %s\n", base_host.cpu_model.c_str(),
+                            base_host.compiler.c_str());
+            }
+            const std::vector<Comparison> comparisons =
+                compare_to_baseline(baseline, results, cfg.threshold, cfg.alpha);
+            print_comparison(comparisons, cfg.threshold, cfg.alpha);
+            for (const Comparison& c : comparisons) {
+                if (c.regression) return ExitRegression;
+            }
+        }
+        return status;
+    }
+
+} // namespace bench
+} // namespace fwilliamsca
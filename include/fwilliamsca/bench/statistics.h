@@ -0,0 +1,137 @@
+/**
+ * @file statistics.h
+ * @brief Robust summary statistics for benchmark samples.
+ * * Timing distributions are skewed (interrupts, frequency transitions), so
+ * the primary estimate is the median with an order-statistic confidence
+ * interval, and spread is reported as the median absolute deviation.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace fwilliamsca {
+namespace bench {
+
+    struct Summary {
+        size_t count = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+        double stddev = 0.0;
+        double median = 0.0;
+        double mad = 0.0;           // Median absolute deviation (unscaled)
+        double p5 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double ci_low = 0.0;        // 95% confidence interval of the median
+        double ci_high = 0.0;
+        size_t outliers = 0;        // Samples beyond median +/- 3 sigma (sigma ~ 1.4826 * MAD)
+    };
+
+    /**
+     * @brief Linear-interpolated percentile of an ascending-sorted sample (q in [0, 1]).
+     */
+    inline double percentile_sorted(const std::vector<double>& sorted, double q) {
+        if (sorted.empty()) return 0.0;
+        const double pos = q * static_cast<double>(sorted.size() - 1);
+        const size_t lo = static_cast<size_t>(pos);
+        const size_t hi = lo + 1 < sorted.size() ? lo + 1 : lo;
+        const double frac = pos - static_cast<double>(lo);
+        return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+    }
+
+    inline Summary summarize(std::vector<double> samples) {
+        Summary s;
+        s.count = samples.size();
+        if (samples.empty()) return s;
+
+        std::sort(samples.begin(), samples.end());
+        const size_t n = samples.size();
+        s.min = samples.front();
+        s.max = samples.back();
+        s.median = percentile_sorted(samples, 0.5);
+        s.p5 = percentile_sorted(samples, 0.05);
+        s.p95 = percentile_sorted(samples, 0.95);
+        s.p99 = percentile_sorted(samples, 0.99);
+
+        double sum = 0.0;
+        for (double v : samples) sum += v;
+        s.mean = sum / static_cast<double>(n);
+        double sq = 0.0;
+        for (double v : samples) sq += (v - s.mean) * (v - s.mean);
+        s.stddev = n > 1 ? std::sqrt(sq / static_cast<double>(n - 1)) : 0.0;
+
+        std::vector<double> dev(n);
+        for (size_t i = 0; i < n; ++i) dev[i] = std::fabs(samples[i] - s.median);
+        std::sort(dev.begin(), dev.end());
+        s.mad = percentile_sorted(dev, 0.5);
+
+        // Distribution-free CI of the median: ranks n/2 -/+ 1.96 * sqrt(n) / 2
+        const double half_width = 0.98 * std::sqrt(static_cast<double>(n));
+        const double lo_rank = std::floor(static_cast<double>(n) / 2.0 - half_width);
+        const double hi_rank = std::ceil(static_cast<double>(n) / 2.0 + half_width);
+        s.ci_low = samples[lo_rank < 0.0 ? 0 : static_cast<size_t>(lo_rank)];
+        s.ci_high = samples[hi_rank > static_cast<double>(n - 1) ? n - 1 : static_cast<size_t>(hi_rank)];
+
+        const double sigma = 1.4826 * s.mad;
+        for (double v : samples) {
+            if (std::fabs(v - s.median) > 3.0 * sigma && sigma > 0.0) ++s.outliers;
+        }
+        return s;
+    }
+
+    // Fewest samples per side for which mann_whitney_greater's normal
+    // approximation is trusted; with fewer, compare_to_baseline falls back
+    // to median-CI non-overlap.
+    inline constexpr size_t MannWhitneyMinSamples = 8;
+
+    /**
+     * @brief One-sided Mann-Whitney U test: p-value for "values in b tend to
+     * be larger than values in a" (normal approximation with tie correction).
+     * The harness may stop at 3 samples, too few for the approximation or
+     * for any p below 0.01; don't rely on it under MannWhitneyMinSamples.
+     */
+    inline double mann_whitney_greater(const std::vector<double>& a, const std::vector<double>& b) {
+        const size_t n1 = a.size();
+        const size_t n2 = b.size();
+        if (n1 == 0 || n2 == 0) return 1.0;
+
+        std::vector<std::pair<double, int>> all;
+        all.reserve(n1 + n2);
+        for (double v : a) all.emplace_back(v, 0);
+        for (double v : b) all.emplace_back(v, 1);
+        std::sort(all.begin(), all.end());
+
+        // Average ranks over ties; accumulate the rank sum of b
+        double rank_sum_b = 0.0;
+        double tie_term = 0.0;
+        for (size_t i = 0; i < all.size();) {
+            size_t j = i;
+            while (j < all.size() && all[j].first == all[i].first) ++j;
+            const double rank = 0.5 * static_cast<double>(i + 1 + j);
+            const double t = static_cast<double>(j - i);
+            tie_term += t * t * t - t;
+            for (size_t k = i; k < j; ++k) {
+                if (all[k].second == 1) rank_sum_b += rank;
+            }
+            i = j;
+        }
+
+        const double N1 = static_cast<double>(n1);
+        const double N2 = static_cast<double>(n2);
+        const double N = N1 + N2;
+        const double u = rank_sum_b - N2 * (N2 + 1.0) / 2.0;
+        const double mean = N1 * N2 / 2.0;
+        const double var = N1 * N2 / 12.0 * ((N + 1.0) - tie_term / (N * (N - 1.0)));
+        if (var <= 0.0) return 1.0;
+        const double z = (u - mean - 0.5) / std::sqrt(var);   // Continuity correction
+        return 0.5 * std::erfc(z / std::sqrt(2.0));
+    }
+
+} // namespace bench
+} // namespace fwilliamsca
@@ -0,0 +1,514 @@
+/**
+ * @file tick_to_trade.h
+ * @brief End-to-end tick-to-trade reference workload with a local exchange.
+ * * Micro-benchmarks of a dot product or an int queue do not show what a
+ * change costs the system. run_tick_to_trade() wires the library's pieces
+ * into the path a trading process actually runs, one Pipeline stage each:
+ *
+ *   feed --> decode --> book --> signal --> risk+encode --> exchange
+ *   (FeedGenerator)                (MathKernel)           (MatchingEngineSim)
+ *
+ * - FeedGenerator paces binary market-data packets (price-level updates
+ *   over a random-walk mid) and publishes the true top of book.
+ * - decode parses the wire bytes, checking sequence numbers.
+ * - book maintains BookDepth levels per instrument and snapshots them.
+ * - signal is a depth-weighted order-book imbalance (two dot products).
+ * - risk checks order size, price band and position limits; encode
+ *   writes the binary order.
+ * - MatchingEngineSim decodes orders and fills them against the feed's
+ *   current top of book (IOC: a stale price misses).
+ *
+ * Every message carries TSC stamps taken as it leaves each stage, so the
+ * exchange records wire-to-wire latency (feed emit -> order arrival) and
+ * per-hop latency (inbound queueing + that stage's work).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../memory/ring_buffer.h"
+#include "../metrics/latency_histogram.h"
+#include "../pipeline/pipeline.h"
+#include "../simd/intrinsics.h"
+#include "../timing/tsc_clock.h"
+
+namespace fwilliamsca {
+namespace bench {
+
+    constexpr size_t BookDepth = 8;
+    constexpr int64_t PriceTick = 100;          // Fixed-point price units per tick (1e-4 scale)
+
+    // Stamp indices: when a message left each stage
+    enum Stamp : size_t { StampWire, StampDecode, StampBook, StampSignal, StampEncode, StampExchange, StampCount };
+
+    constexpr size_t HopCount = StampCount - 1;
+
+    inline const char* hop_name(size_t hop) {
+        static const char* const names[HopCount] = {"decode", "book", "signal", "risk+encode", "exchange"};
+        return hop < HopCount ? names[hop] : "?";
+    }
+
+    struct HopStamps {
+        uint64_t t[StampCount];
+    };
+
+    namespace detail {
+
+        inline uint64_t xorshift(uint64_t& s) {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            return s;
+        }
+
+        template <typename T>
+        void put(uint8_t* p, size_t offset, T v) {
+            std::memcpy(p + offset, &v, sizeof(T));
+        }
+
+        template <typename T>
+        T get(const uint8_t* p, size_t offset) {
+            T v;
+            std::memcpy(&v, p + offset, sizeof(T));
+            return v;
+        }
+
+    } // namespace detail
+
+    // ---------------------------------------------------------------- Wire formats
+
+    /**
+     * @brief Market-data frame: seq u64 | send_tsc u64 | price i64 |
+     * instrument u32 | qty u32 | level u8 | side u8 (0 bid, 1 ask).
+     */
+    struct FeedPacket {
+        static constexpr size_t Size = 34;
+        uint8_t data[40];
+    };
+
+    /**
+     * @brief Order frame: client_id u64 | price i64 | instrument u32 |
+     * qty u32 | side u8 (0 buy, 1 sell). Stamps travel out of band, like
+     * NIC hardware timestamps.
+     */
+    struct OrderWire {
+        static constexpr size_t Size = 25;
+        uint8_t data[32];
+        HopStamps stamps;
+    };
+
+    // ---------------------------------------------------------------- Internal messages
+
+    struct MarketUpdate {
+        uint64_t seq;
+        int64_t price;
+        uint32_t instrument;
+        uint32_t qty;
+        uint8_t level;
+        uint8_t side;
+        HopStamps stamps;
+    };
+
+    struct BookSnapshot {
+        uint32_t instrument;
+        int64_t best_bid;
+        int64_t best_ask;
+        alignas(32) double bid_qty[BookDepth];
+        alignas(32) double ask_qty[BookDepth];
+        HopStamps stamps;
+    };
+
+    struct OrderIntent {
+        uint64_t client_id;
+        int64_t price;
+        uint32_t instrument;
+        uint32_t qty;
+        uint8_t side;
+        double signal;
+        HopStamps stamps;
+    };
+
+    // ---------------------------------------------------------------- Exchange side
+
+    /**
+     * @brief True top of book per instrument, written by the feed and read
+     * by the matching engine.
+     */
+    class ExchangeState {
+    public:
+        explicit ExchangeState(size_t instruments) : quotes_(new Quote[instruments]), size_(instruments) {}
+
+        size_t instruments() const { return size_; }
+
+        void publish(uint32_t instrument, int64_t bid, int64_t ask) {
+            quotes_[instrument].bid.store(bid, std::memory_order_relaxed);
+            quotes_[instrument].ask.store(ask, std::memory_order_relaxed);
+        }
+
+        int64_t bid(uint32_t instrument) const { return quotes_[instrument].bid.load(std::memory_order_relaxed); }
+        int64_t ask(uint32_t instrument) const { return quotes_[instrument].ask.load(std::memory_order_relaxed); }
+
+    private:
+        struct alignas(CACHE_LINE_SIZE) Quote {
+            std::atomic<int64_t> bid{0};
+            std::atomic<int64_t> ask{0};
+        };
+        std::unique_ptr<Quote[]> quotes_;
+        size_t size_;
+    };
+
+    /**
+     * @brief Paced synthetic feed: each packet updates one price level of
+     * one instrument; 1 in 16 first moves that instrument's mid by a tick.
+     */
+    class FeedGenerator {
+    public:
+        /**
+         * @param interval_ticks TSC ticks between packets (0: as fast as possible).
+         *        A generator that falls behind catches up in a burst.
+         */
+        FeedGenerator(ExchangeState& exchange, size_t packets, uint64_t interval_ticks, uint64_t seed = 0x9e3779b97f4a7c15)
+            : exchange_(exchange), remaining_(packets), interval_(interval_ticks), rng_(seed | 1),
+              mids_(exchange.instruments()) {
+            for (size_t i = 0; i < mids_.size(); ++i) {
+                mids_[i] = static_cast<int64_t>(1000 + 10 * i) * 10000;
+                exchange_.publish(static_cast<uint32_t>(i), mids_[i] - PriceTick, mids_[i] + PriceTick);
+            }
+        }
+
+        size_t remaining() const { return remaining_; }
+
+        /**
+         * @brief Pipeline source step: false until the next send time.
+         */
+        bool operator()(FeedPacket& out) {
+            if (remaining_ == 0) return false;
+            const uint64_t now = timing::rdtsc();
+            if (interval_ != 0) {
+                if (next_send_ == 0) next_send_ = now;
+                if (now < next_send_) return false;
+                next_send_ += interval_;
+            }
+            --remaining_;
+
+            const uint64_t r = detail::xorshift(rng_);
+            const uint32_t instrument = static_cast<uint32_t>(r % mids_.size());
+            int64_t& mid = mids_[instrument];
+            if (((r >> 20) & 15) == 0) {
+                mid += ((r >> 24) & 1) ? PriceTick : -PriceTick;
+                exchange_.publish(instrument, mid - PriceTick, mid + PriceTick);
+            }
+            const uint8_t side = static_cast<uint8_t>((r >> 25) & 1);
+            // Inner levels update most often
+            const uint8_t level = static_cast<uint8_t>(std::min<uint64_t>(__builtin_ctzll((r >> 28) | (uint64_t(1) << 40)), BookDepth - 1));
+            const int64_t offset = static_cast<int64_t>(level + 1) * PriceTick;
+            const int64_t price = side == 0 ? mid - offset : mid + offset;
+            const uint32_t qty = static_cast<uint32_t>(1 + ((r >> 40) % 500));
+
+            detail::put<uint64_t>(out.data, 0, seq_++);
+            detail::put<int64_t>(out.data, 16, price);
+            detail::put<uint32_t>(out.data, 24, instrument);
+            detail::put<uint32_t>(out.data, 28, qty);
+            out.data[32] = level;
+            out.data[33] = side;
+            detail::put<uint64_t>(out.data, 8, timing::rdtsc());   // Last: the packet hits the wire
+            return true;
+        }
+
+    private:
+        ExchangeState& exchange_;
+        size_t remaining_;
+        uint64_t interval_;
+        uint64_t next_send_ = 0;
+        uint64_t seq_ = 0;
+        uint64_t rng_;
+        std::vector<int64_t> mids_;
+    };
+
+    struct ExchangeStats {
+        uint64_t orders = 0;
+        uint64_t fills = 0;
+        uint64_t misses = 0;        // IOC price no longer marketable on arrival
+    };
+
+    /**
+     * @brief Order-entry side of the exchange: decodes, matches IOC orders
+     * against the live top of book, and records latency (TSC ticks).
+     */
+    class MatchingEngineSim {
+    public:
+        explicit MatchingEngineSim(const ExchangeState& exchange) : exchange_(exchange) {}
+
+        void operator()(OrderWire& order) {
+            const uint64_t now = timing::rdtsc();
+            order.stamps.t[StampExchange] = now;
+
+            const int64_t price = detail::get<int64_t>(order.data, 8);
+            const uint32_t instrument = detail::get<uint32_t>(order.data, 16);
+            const bool buy = order.data[24] == 0;
+            const bool filled = buy ? price >= exchange_.ask(instrument) : price <= exchange_.bid(instrument);
+            ++stats_.orders;
+            ++(filled ? stats_.fills : stats_.misses);
+
+            const uint64_t* t = order.stamps.t;
+            wire_to_wire_.record(now - t[StampWire]);
+            for (size_t h = 0; h < HopCount; ++h) {
+                hops_[h].record(t[h + 1] > t[h] ? t[h + 1] - t[h] : 0);
+            }
+        }
+
+        const ExchangeStats& stats() const { return stats_; }
+        const metrics::LatencyHistogram<>& wire_to_wire() const { return wire_to_wire_; }
+        const metrics::LatencyHistogram<>& hop(size_t h) const { return hops_[h]; }
+
+    private:
+        const ExchangeState& exchange_;
+        ExchangeStats stats_;
+        metrics::LatencyHistogram<> wire_to_wire_;
+        std::array<metrics::LatencyHistogram<>, HopCount> hops_;
+    };
+
+    // ---------------------------------------------------------------- Strategy side
+
+    /**
+     * @brief Parses feed frames; counts sequence gaps and malformed frames.
+     */
+    class FeedDecoder {
+    public:
+        bool operator()(FeedPacket& in, MarketUpdate& out) {
+            out.seq = detail::get<uint64_t>(in.data, 0);
+            out.stamps.t[StampWire] = detail::get<uint64_t>(in.data, 8);
+            out.price = detail::get<int64_t>(in.data, 16);
+            out.instrument = detail::get<uint32_t>(in.data, 24);
+            out.qty = detail::get<uint32_t>(in.data, 28);
+            out.level = in.data[32];
+            out.side = in.data[33];
+            out.stamps.t[StampDecode] = timing::rdtsc();
+            if (out.seq != expected_seq_) ++gaps_;
+            expected_seq_ = out.seq + 1;
+            if (out.level >= BookDepth || out.side > 1) {
+                ++malformed_;
+                return false;
+            }
+            return true;
+        }
+
+        uint64_t gaps() const { return gaps_; }
+        uint64_t malformed() const { return malformed_; }
+
+    private:
+        uint64_t expected_seq_ = 0;
+        uint64_t gaps_ = 0;
+        uint64_t malformed_ = 0;
+    };
+
+    /**
+     * @brief Depth-BookDepth price-level book per instrument.
+     */
+    class OrderBook {
+    public:
+        explicit OrderBook(size_t instruments) : books_(instruments) {}
+
+        bool operator()(MarketUpdate& in, BookSnapshot& out) {
+            Book& b = books_[in.instrument];
+            if (in.side == 0) {
+                b.bid_px[in.level] = in.price;
+                b.bid_qty[in.level] = in.qty;
+            } else {
+                b.ask_px[in.level] = in.price;
+                b.ask_qty[in.level] = in.qty;
+            }
+            out.instrument = in.instrument;
+            out.best_bid = b.bid_px[0];
+            out.best_ask = b.ask_px[0];
+            std::memcpy(out.bid_qty, b.bid_qty, sizeof(out.bid_qty));
+            std::memcpy(out.ask_qty, b.ask_qty, sizeof(out.ask_qty));
+            out.stamps = in.stamps;
+            out.stamps.t[StampBook] = timing::rdtsc();
+            // Nothing to trade until both sides have a top level
+            return out.best_bid != 0 && out.best_ask != 0;
+        }
+
+    private:
+        struct Book {
+            int64_t bid_px[BookDepth] = {};
+            int64_t ask_px[BookDepth] = {};
+            double bid_qty[BookDepth] = {};
+            double ask_qty[BookDepth] = {};
+        };
+        std::vector<Book> books_;
+    };
+
+    /**
+     * @brief Depth-weighted book imbalance in [-1, 1]; trades through the
+     * touch when it exceeds the threshold.
+     */
+    class ImbalanceSignal {
+    public:
+        explicit ImbalanceSignal(double threshold) : threshold_(threshold) {
+            for (size_t i = 0; i < BookDepth; ++i) weights_[i] = 1.0 / static_cast<double>(i + 1);
+        }
+
+        bool operator()(BookSnapshot& in, OrderIntent& out) {
+            const double bid = simd::MathKernel<>::dot_product(weights_, in.bid_qty, BookDepth);
+            const double ask = simd::MathKernel<>::dot_product(weights_, in.ask_qty, BookDepth);
+            const double total = bid + ask;
+            const double signal = total > 0.0 ? (bid - ask) / total : 0.0;
+            if (signal < threshold_ && signal > -threshold_) return false;
+
+            out.client_id = next_id_++;
+            out.instrument = in.instrument;
+            out.side = signal > 0.0 ? 0 : 1;                // Bid-heavy book: buy at the ask
+            out.price = signal > 0.0 ? in.best_ask : in.best_bid;
+            out.qty = 10;
+            out.signal = signal;
+            out.stamps = in.stamps;
+            out.stamps.t[StampSignal] = timing::rdtsc();
+            return true;
+        }
+
+    private:
+        alignas(64) double weights_[BookDepth];
+        double threshold_;
+        uint64_t next_id_ = 1;
+    };
+
+    struct RiskLimits {
+        uint32_t max_order_qty = 100;
+        int64_t max_position = 200;         // Per instrument, in lots
+        int64_t price_band = 50 * PriceTick; // Max distance from the previous order's price
+    };
+
+    /**
+     * @brief Pre-trade checks; positions assume every order fills.
+     */
+    class RiskCheck {
+    public:
+        RiskCheck(size_t instruments, RiskLimits limits)
+            : limits_(limits), position_(instruments), last_price_(instruments) {}
+
+        bool operator()(OrderIntent& in, OrderIntent& out) {
+            const int64_t signed_qty = in.side == 0 ? in.qty : -static_cast<int64_t>(in.qty);
+            int64_t& pos = position_[in.instrument];
+            int64_t& last = last_price_[in.instrument];
+            const bool ok = in.qty <= limits_.max_order_qty &&
+                            (last == 0 || std::abs(in.price - last) <= limits_.price_band) &&
+                            std::abs(pos + signed_qty) <= limits_.max_position;
+            if (!ok) return false;
+            pos += signed_qty;
+            last = in.price;
+            out = in;
+            return true;
+        }
+
+    private:
+        RiskLimits limits_;
+        std::vector<int64_t> position_;
+        std::vector<int64_t> last_price_;
+    };
+
+    inline bool encode_order(OrderIntent& in, OrderWire& out) {
+        detail::put<uint64_t>(out.data, 0, in.client_id);
+        detail::put<int64_t>(out.data, 8, in.price);
+        detail::put<uint32_t>(out.data, 16, in.instrument);
+        detail::put<uint32_t>(out.data, 20, in.qty);
+        out.data[24] = in.side;
+        out.stamps = in.stamps;
+        out.stamps.t[StampEncode] = timing::rdtsc();
+        return true;
+    }
+
+    // ---------------------------------------------------------------- Runner
+
+    struct TickToTradeConfig {
+        size_t packets = 200000;
+        size_t instruments = 64;
+        double feed_rate_mpps = 1.0;        // Million packets/s (0: as fast as possible)
+        double signal_threshold = 0.3;
+        RiskLimits limits;
+        std::vector<int> cores;             // One per stage (6); shorter lists leave the rest unpinned
+        size_t idle_spins = 1024;           // Empty polls before a stage yields (0: never)
+    };
+
+    struct TickToTradeReport {
+        metrics::LatencyHistogram<> wire_to_wire;   // TSC ticks
+        std::array<metrics::LatencyHistogram<>, HopCount> hops;
+        ExchangeStats exchange;
+        uint64_t seq_gaps = 0;
+        uint64_t malformed = 0;
+        std::vector<std::pair<std::string, pipeline::StageStats>> stages;
+        double seconds = 0.0;
+    };
+
+    /**
+     * @brief Runs the whole path for cfg.packets feed packets and drains it.
+     */
+    inline TickToTradeReport run_tick_to_trade(const TickToTradeConfig& cfg) {
+        constexpr size_t RingSize = 4096;
+        auto wire = std::make_unique<memory::SPSCRingBuffer<FeedPacket, RingSize>>();
+        auto updates = std::make_unique<memory::SPSCRingBuffer<MarketUpdate, RingSize>>();
+        auto books = std::make_unique<memory::SPSCRingBuffer<BookSnapshot, RingSize>>();
+        auto intents = std::make_unique<memory::SPSCRingBuffer<OrderIntent, RingSize>>();
+        auto orders = std::make_unique<memory::SPSCRingBuffer<OrderWire, RingSize>>();
+
+        const timing::TscClock& tsc = timing::TscClock::instance();
+        const uint64_t interval =
+            cfg.feed_rate_mpps > 0.0 ? static_cast<uint64_t>(tsc.ghz() * 1e3 / cfg.feed_rate_mpps) : 0;
+
+        ExchangeState exchange(cfg.instruments);
+        FeedGenerator feed(exchange, cfg.packets, interval);
+        MatchingEngineSim engine(exchange);
+        FeedDecoder decoder;
+        OrderBook book(cfg.instruments);
+        ImbalanceSignal signal(cfg.signal_threshold);
+        RiskCheck risk(cfg.instruments, cfg.limits);
+
+        auto stage = [&](size_t i) {
+            pipeline::StageConfig sc;
+            sc.core = i < cfg.cores.size() ? cfg.cores[i] : -1;
+            sc.idle_spins = cfg.idle_spins;
+            return sc;
+        };
+
+        pipeline::Pipeline<> pipe;
+        const size_t feed_stage = pipe.add_source("feed", *wire, std::ref(feed), stage(0));
+        pipe.add_stage("decode", *wire, *updates, std::ref(decoder), stage(1));
+        pipe.add_stage("book", *updates, *books, std::ref(book), stage(2));
+        pipe.add_stage("signal", *books, *intents, std::ref(signal), stage(3));
+        auto check = [&risk](OrderIntent& in, OrderIntent& out) { return risk(in, out); };
+        pipe.add_stage("risk+encode", *intents, *orders, pipeline::fuse(check, encode_order), stage(4));
+        pipe.add_sink("exchange", *orders, std::ref(engine), stage(5));
+
+        const auto t0 = std::chrono::steady_clock::now();
+        pipe.start();
+        while (pipe.stats(feed_stage).messages_in != cfg.packets) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        pipe.stop();    // Upstream first: drains every in-flight message
+        const auto t1 = std::chrono::steady_clock::now();
+
+        TickToTradeReport report;
+        report.wire_to_wire = engine.wire_to_wire();
+        for (size_t h = 0; h < HopCount; ++h) report.hops[h] = engine.hop(h);
+        report.exchange = engine.stats();
+        report.seq_gaps = decoder.gaps();
+        report.malformed = decoder.malformed();
+        for (size_t i = 0; i < pipe.num_stages(); ++i) report.stages.emplace_back(pipe.name(i), pipe.stats(i));
+        report.seconds = std::chrono::duration<double>(t1 - t0).count();
+        return report;
+    }
+
+} // namespace bench
+} // namespace fwilliamsca
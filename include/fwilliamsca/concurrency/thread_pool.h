@@ -0,0 +1,161 @@
+/**
+ * @file thread_pool.h
+ * @brief Persistent fork-join thread pool for bulk data-parallel kernels.
+ * * Designed for throughput work (end-of-day risk, large array kernels),
+ * not for the tick-to-trade path.
+ * - Workers are created once and parked on an atomic wait between jobs.
+ * - Job dispatch is allocation-free: the callable is passed by reference.
+ * - The submitting thread participates in the job, so a pool of N threads
+ *   runs N-1 workers.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+namespace fwilliamsca {
+namespace concurrency {
+
+    class ThreadPool {
+    public:
+        /**
+         * @param num_threads Total parallelism including the calling thread.
+         * Zero selects std::thread::hardware_concurrency().
+         */
+        explicit ThreadPool(size_t num_threads = 0) {
+            if (num_threads == 0) {
+                num_threads = std::thread::hardware_concurrency();
+            }
+            if (num_threads == 0) {
+                num_threads = 1;
+            }
+            workers_.reserve(num_threads - 1);
+            for (size_t i = 0; i + 1 < num_threads; ++i) {
+                workers_.emplace_back([this]() { worker_loop(); });
+            }
+        }
+
+        ~ThreadPool() {
+            stop_.store(true, std::memory_order_relaxed);
+            generation_.fetch_add(1, std::memory_order_release);
+            generation_.notify_all();
+            for (auto& t : workers_) {
+                t.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Total parallelism (workers + the submitting thread).
+         */
+        size_t size() const { return workers_.size() + 1; }
+
+        /**
+         * @brief Runs fn(task) for every task in [0, num_tasks) and blocks
+         * until all of them have completed.
+         * * Tasks are claimed dynamically, so which thread runs which task is
+         * unspecified; callers needing determinism must make each task's
+         * output depend only on its index. fn must not throw.
+         * * A nested call from inside one of this pool's tasks runs all of its
+         * tasks inline on the calling thread: the other workers may be busy
+         * in the outer job, and waiting on them would deadlock.
+         */
+        template <typename F>
+        void parallel_for(size_t num_tasks, F&& fn) {
+            if (num_tasks == 0) {
+                return;
+            }
+            if (workers_.empty() || num_tasks == 1 || current_pool() == this) {
+                for (size_t t = 0; t < num_tasks; ++t) fn(t);
+                return;
+            }
+
+            using Fn = std::remove_reference_t<F>;
+            std::lock_guard<std::mutex> lock(submit_mutex_);
+
+            ctx_ = const_cast<void*>(static_cast<const void*>(std::addressof(fn)));
+            invoke_ = [](void* ctx, size_t task) { (*static_cast<Fn*>(ctx))(task); };
+            num_tasks_ = num_tasks;
+            next_task_.store(0, std::memory_order_relaxed);
+            finished_.store(0, std::memory_order_relaxed);
+
+            // Publish the job (release pairs with the workers' acquire)
+            generation_.fetch_add(1, std::memory_order_release);
+            generation_.notify_all();
+
+            ThreadPool* const outer = current_pool();
+            current_pool() = this;
+            run_tasks();
+            current_pool() = outer;
+
+            // Every worker checks in once per job, so no straggler can still be
+            // reading job state when the next submission overwrites it.
+            const size_t expected = workers_.size();
+            size_t done = finished_.load(std::memory_order_acquire);
+            while (done != expected) {
+                finished_.wait(done, std::memory_order_acquire);
+                done = finished_.load(std::memory_order_acquire);
+            }
+        }
+
+    private:
+        // Pool whose task the calling thread is running, if any
+        static ThreadPool*& current_pool() {
+            thread_local ThreadPool* pool = nullptr;
+            return pool;
+        }
+
+        void run_tasks() {
+            size_t task;
+            while ((task = next_task_.fetch_add(1, std::memory_order_relaxed)) < num_tasks_) {
+                invoke_(ctx_, task);
+            }
+        }
+
+        void worker_loop() {
+            // Generation starts at zero and only advances once every worker has
+            // checked in, so each worker observes every job exactly once.
+            uint64_t seen = 0;
+            current_pool() = this;
+            for (;;) {
+                generation_.wait(seen, std::memory_order_acquire);
+                seen = generation_.load(std::memory_order_acquire);
+                if (stop_.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                run_tasks();
+                finished_.fetch_add(1, std::memory_order_release);
+                finished_.notify_one();
+            }
+        }
+
+        std::vector<std::thread> workers_;
+        std::mutex submit_mutex_;
+
+        // Job description (written by the submitter before the generation bump)
+        void (*invoke_)(void*, size_t) = nullptr;
+        void* ctx_ = nullptr;
+        size_t num_tasks_ = 0;
+
+        // Contended counters live on their own cache lines
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> next_task_{0};
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> finished_{0};
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> generation_{0};
+        std::atomic<bool> stop_{false};
+    };
+
+} // namespace concurrency
+} // namespace fwilliamsca
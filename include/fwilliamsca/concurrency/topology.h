@@ -0,0 +1,164 @@
+/**
+ * @file topology.h
+ * @brief CPU topology discovery (SMT siblings, shared L3, sockets) from sysfs.
+ * * Used to decide where pipeline stages are pinned: the cost of a cache line
+ * hand-off depends on whether two cores share a physical core, an L3
+ * slice/CCX, a socket, or nothing at all. The data cache hierarchy is
+ * exposed as well, for sizing working sets and annotating bandwidth sweeps.
+ */
+
+#pragma once
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <sched.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace fwilliamsca {
+namespace concurrency {
+
+    enum class CpuRelation {
+        Same,           // Identical logical CPU
+        SmtSibling,     // Hyper-threads of one physical core
+        SharedL3,       // Different cores sharing a last-level cache (same CCX/die)
+        SameSocket,     // Same package, different L3 domain
+        CrossSocket,    // Different packages (inter-socket link)
+        Unknown         // Topology of either CPU not available
+    };
+
+    inline const char* to_string(CpuRelation r) {
+        switch (r) {
+            case CpuRelation::Same:        return "same";
+            case CpuRelation::SmtSibling:  return "smt";
+            case CpuRelation::SharedL3:    return "l3";
+            case CpuRelation::SameSocket:  return "socket";
+            case CpuRelation::CrossSocket: return "remote";
+            case CpuRelation::Unknown:     return "unknown";
+        }
+        return "?";
+    }
+
+    struct CpuInfo {
+        int cpu = -1;
+        int package = -1;
+        int core = -1;
+        int l3 = -1;    // Lowest CPU id sharing this CPU's L3 (-1 if unknown)
+    };
+
+    struct CacheLevel {
+        int level = 0;          // 1 = L1d, 2 = L2, ...
+        size_t size = 0;        // Bytes
+    };
+
+    /**
+     * @brief Data/unified caches of one CPU, innermost first (empty if sysfs
+     * does not describe them).
+     */
+    inline std::vector<CacheLevel> data_cache_levels(int cpu = 0) {
+        std::vector<CacheLevel> levels;
+        const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/index";
+        for (int index = 0;; ++index) {
+            const std::string dir = base + std::to_string(index);
+            std::FILE* f = std::fopen((dir + "/type").c_str(), "r");
+            if (!f) break;
+            char type[32] = {};
+            const bool ok = std::fscanf(f, "%31s", type) == 1;
+            std::fclose(f);
+            if (!ok || std::string(type) == "Instruction") continue;
+
+            CacheLevel c;
+            f = std::fopen((dir + "/level").c_str(), "r");
+            if (f) {
+                if (std::fscanf(f, "%d", &c.level) != 1) c.level = 0;
+                std::fclose(f);
+            }
+            f = std::fopen((dir + "/size").c_str(), "r");
+            if (f) {
+                unsigned long value = 0;
+                char suffix = 0;
+                if (std::fscanf(f, "%lu%c", &value, &suffix) >= 1) {
+                    c.size = value;
+                    if (suffix == 'K') c.size <<= 10;
+                    else if (suffix == 'M') c.size <<= 20;
+                    else if (suffix == 'G') c.size <<= 30;
+                }
+                std::fclose(f);
+            }
+            if (c.level > 0 && c.size > 0) levels.push_back(c);
+        }
+        std::sort(levels.begin(), levels.end(),
+                  [](const CacheLevel& a, const CacheLevel& b) { return a.level < b.level; });
+        return levels;
+    }
+
+    class CpuTopology {
+    public:
+        /**
+         * @brief Reads the topology of every CPU in the calling thread's
+         * affinity mask. Missing sysfs entries degrade to -1 fields.
+         */
+        static CpuTopology detect() {
+            CpuTopology topo;
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+                return topo;
+            }
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (!CPU_ISSET(cpu, &set)) continue;
+                const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+                CpuInfo info;
+                info.cpu = cpu;
+                info.package = read_int(base + "/topology/physical_package_id");
+                info.core = read_int(base + "/topology/core_id");
+                // shared_cpu_list is "0-7,64-71": the leading id names the L3 domain
+                info.l3 = read_int(base + "/cache/index3/shared_cpu_list");
+                topo.cpus_.push_back(info);
+            }
+            return topo;
+        }
+
+        const std::vector<CpuInfo>& cpus() const { return cpus_; }
+        size_t size() const { return cpus_.size(); }
+
+        const CpuInfo* find(int cpu) const {
+            for (const auto& c : cpus_) {
+                if (c.cpu == cpu) return &c;
+            }
+            return nullptr;
+        }
+
+        CpuRelation relation(int a, int b) const {
+            if (a == b) return CpuRelation::Same;
+            const CpuInfo* x = find(a);
+            const CpuInfo* y = find(b);
+            if (!x || !y || x->package < 0 || y->package < 0) return CpuRelation::Unknown;
+            if (x->package != y->package) return CpuRelation::CrossSocket;
+            if (x->core >= 0 && x->core == y->core) return CpuRelation::SmtSibling;
+            if (x->l3 >= 0 && x->l3 == y->l3) return CpuRelation::SharedL3;
+            return CpuRelation::SameSocket;
+        }
+
+    private:
+        // Parses the leading integer of a sysfs file (-1 if absent)
+        static int read_int(const std::string& path) {
+            std::FILE* f = std::fopen(path.c_str(), "r");
+            if (!f) return -1;
+            int v = -1;
+            if (std::fscanf(f, "%d", &v) != 1) v = -1;
+            std::fclose(f);
+            return v;
+        }
+
+        std::vector<CpuInfo> cpus_;
+    };
+
+} // namespace concurrency
+} // namespace fwilliamsca
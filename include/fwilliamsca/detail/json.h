@@ -0,0 +1,52 @@
+/**
+ * @file json.h
+ * @brief JSON string escaping and number formatting shared by the benchmark
+ * report and trace writers.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace fwilliamsca {
+namespace detail {
+
+    /**
+     * @brief Escapes s for use inside a JSON string literal (quotes not added).
+     */
+    inline std::string json_escape(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        out += buf;
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Formats v as a JSON number (%.6g); nan and inf, which JSON
+     * cannot represent, become null.
+     */
+    inline std::string json_number(double v) {
+        if (!std::isfinite(v)) return "null";
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.6g", v);
+        return buf;
+    }
+
+} // namespace detail
+} // namespace fwilliamsca
@@ -0,0 +1,168 @@
+/**
+ * @file notifying_ring_buffer.h
+ * @brief SPSC queue whose consumer can block in epoll/poll alongside sockets.
+ * * Wraps SPSCRingBuffer with an eventfd. The producer only signals the fd
+ * when the consumer has advertised that it is about to sleep, so while the
+ * consumer is active a push costs the plain ring push plus one fence and one
+ * flag load (no syscall).
+ *
+ * Consumer protocol (e.g. a gateway thread that also serves sockets):
+ *
+ *   epoll_ctl(ep, EPOLL_CTL_ADD, ring.fd(), ...);
+ *   for (;;) {
+ *       while (ring.try_pop(msg)) handle(msg);
+ *       if (ring.prepare_wait()) {          // Ring still empty: safe to block
+ *           epoll_wait(ep, events, n, -1);
+ *       }
+ *       ring.finish_wait();                 // Re-arm and drain the eventfd
+ *       ...socket events...
+ *   }
+ *
+ * Lost-wakeup freedom (Dekker handshake): the producer publishes the item
+ * then reads sleeping_; the consumer publishes sleeping_ then re-checks the
+ * ring. A full fence on both sides guarantees at least one of them sees the
+ * other's store.
+ */
+
+#pragma once
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+#include <utility>
+
+#include "ring_buffer.h"
+
+namespace fwilliamsca {
+namespace memory {
+
+    template <typename T, size_t Capacity, typename Telemetry = NoRingTelemetry>
+    class NotifyingSPSCRingBuffer {
+    public:
+        using value_type = T;
+
+        NotifyingSPSCRingBuffer() {
+            fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (fd_ < 0) {
+                throw std::system_error(errno, std::generic_category(), "eventfd");
+            }
+        }
+
+        ~NotifyingSPSCRingBuffer() {
+            close(fd_);
+        }
+
+        NotifyingSPSCRingBuffer(const NotifyingSPSCRingBuffer&) = delete;
+        NotifyingSPSCRingBuffer& operator=(const NotifyingSPSCRingBuffer&) = delete;
+
+        /**
+         * @brief File descriptor that becomes readable when the sleeping
+         * consumer has data. Register it with epoll (EPOLLIN).
+         */
+        int fd() const { return fd_; }
+
+        // ---- Producer side ----------------------------------------------
+
+        template <typename U>
+        bool try_push(U&& item) {
+            if (!ring_.try_push(std::forward<U>(item))) {
+                return false;
+            }
+            notify_if_sleeping();
+            return true;
+        }
+
+        size_t try_push_bulk(T* items, size_t count) {
+            const size_t n = ring_.try_push_bulk(items, count);
+            if (n != 0) {
+                notify_if_sleeping();
+            }
+            return n;
+        }
+
+        // ---- Consumer side ----------------------------------------------
+
+        bool try_pop(T& out_item) { return ring_.try_pop(out_item); }
+
+        size_t try_pop_bulk(T* out, size_t max_items) { return ring_.try_pop_bulk(out, max_items); }
+
+        bool empty() const { return ring_.empty(); }
+
+        RingTelemetrySnapshot telemetry() const { return ring_.telemetry(); }
+        const metrics::LatencyHistogram<>& latency() const { return ring_.latency(); }
+
+        /**
+         * @brief Advertises that the consumer is about to block on fd().
+         * @return true if the ring is still empty and blocking is safe;
+         * false if data arrived in the meantime (do not block).
+         * Call finish_wait() afterwards in both cases.
+         */
+        bool prepare_wait() {
+            sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return ring_.empty();
+        }
+
+        /**
+         * @brief Withdraws the sleep advertisement and drains the eventfd so
+         * it is level-low again for the next wait.
+         */
+        void finish_wait() {
+            sleeping_.store(false, std::memory_order_relaxed);
+            uint64_t count;
+            while (read(fd_, &count, sizeof(count)) < 0 && errno == EINTR) {
+            }
+        }
+
+        /**
+         * @brief Standalone blocking wait (no epoll): returns once the ring is
+         * non-empty or timeout_ms elapses (-1 waits forever).
+         * @return true if the ring has data.
+         */
+        bool wait(int timeout_ms = -1) {
+            if (prepare_wait()) {
+                pollfd pfd{fd_, POLLIN, 0};
+                while (poll(&pfd, 1, timeout_ms) < 0 && errno == EINTR) {
+                }
+            }
+            finish_wait();
+            return !ring_.empty();
+        }
+
+        /**
+         * @brief Number of eventfd signals issued (producer-owned counter).
+         */
+        uint64_t notifications() const { return notifications_.load(std::memory_order_relaxed); }
+
+    private:
+        void notify_if_sleeping() {
+            // Order the tail_ publication before the sleeping_ read
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleeping_.load(std::memory_order_relaxed) &&
+                sleeping_.exchange(false, std::memory_order_relaxed)) {
+                const uint64_t one = 1;
+                while (write(fd_, &one, sizeof(one)) < 0 && errno == EINTR) {
+                }
+                notifications_.store(notifications_.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+            }
+        }
+
+        SPSCRingBuffer<T, Capacity, Telemetry> ring_;
+
+        // Consumer advertises sleep here; producer reads (and clears) it
+        alignas(CACHE_LINE_SIZE) std::atomic<bool> sleeping_{false};
+
+        // Producer-owned
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> notifications_{0};
+
+        int fd_ = -1;
+    };
+
+} // namespace memory
+} // namespace fwilliamsca
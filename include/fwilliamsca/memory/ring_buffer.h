@@ -5,6 +5,8 @@
  * * Optimized for Tick-To-Trade latency.
  * - Enforces explicit cache-line alignment to prevent False Sharing.
  * - Uses std::memory_order_release/acquire for minimal synchronization overhead.
+ * - Optional occupancy/stall counters and sampled queueing latency via the
+ *   Telemetry policy (ring_telemetry.h).
  */
 
 #pragma once
@@ -16,6 +18,9 @@
 #include <new>
 #include <type_traits>
 
+#include "ring_telemetry.h"
+#include "../trace/trace.h"
+
 #ifndef CACHE_LINE_SIZE
 #define CACHE_LINE_SIZE 64
 #endif
@@ -23,7 +28,7 @@
 namespace fwilliamsca {
 namespace memory {
 
-    template <typename T, size_t Capacity>
+    template <typename T, size_t Capacity, typename Telemetry = NoRingTelemetry>
     class SPSCRingBuffer {
         static_assert((Capacity != 0) && ((Capacity & (Capacity - 1)) == 0), 
                       "Capacity must be a power of 2 for bitwise wrapping optimization.");
@@ -38,10 +43,19 @@ namespace memory {
                 throw std::bad_alloc();
             }
             buffer_ = static_cast<T*>(ptr);
+
+            if constexpr (Telemetry::LatencySampleEvery != 0) {
+                if (posix_memalign(&ptr, CACHE_LINE_SIZE, sizeof(uint64_t) * Capacity) != 0) {
+                    free(buffer_);
+                    throw std::bad_alloc();
+                }
+                stamps_ = static_cast<uint64_t*>(ptr);
+            }
         }
 
         ~SPSCRingBuffer() {
             free(buffer_);
+            free(stamps_);
         }
 
         /**
@@ -57,15 +71,21 @@ namespace memory {
             const size_t next_tail = (current_tail + 1) & (Capacity - 1);
 
             // Check if full (acquire load on head to see consumer's updates)
-            if (next_tail == head_.load(std::memory_order_acquire)) {
+            const size_t head = head_.load(std::memory_order_acquire);
+            if (next_tail == head) {
+                producer_telemetry_.on_full();
                 return false; 
             }
 
             // Construct in-place
             new (&buffer_[current_tail]) T(std::forward<U>(item));
+            if constexpr (Telemetry::LatencySampleEvery != 0) {
+                producer_telemetry_.stamp(stamps_, current_tail, 1, Capacity - 1);
+            }
 
             // Commit the push
             tail_.store(next_tail, std::memory_order_release);
+            producer_telemetry_.on_push(1, (next_tail - head) & (Capacity - 1));
             return true;
         }
 
@@ -78,9 +98,14 @@ namespace memory {
 
             // Check if empty (acquire load on tail to see producer's updates)
             if (current_head == tail_.load(std::memory_order_acquire)) {
+                consumer_telemetry_.on_empty();
                 return false;
             }
 
+            if constexpr (Telemetry::LatencySampleEvery != 0) {
+                consumer_telemetry_.record_latency(stamps_, current_head, 1, Capacity - 1);
+            }
+
             // Move assignment
             out_item = std::move(buffer_[current_head]);
             
@@ -89,10 +114,80 @@ namespace memory {
 
             const size_t next_head = (current_head + 1) & (Capacity - 1);
             head_.store(next_head, std::memory_order_release);
+            consumer_telemetry_.on_pop(1);
             
             return true;
         }
 
+        /**
+         * @brief Enqueues up to count items (moved from items) with a single
+         * release of tail_. Amortizes the cross-core handshake over a batch.
+         * @return Number of items enqueued (0 if buffer is full).
+         * Traced (non-empty batches only) when built with FWILLIAMSCA_TRACE.
+         */
+        size_t try_push_bulk(T* items, size_t count) {
+            FWILLIAMSCA_TRACE_MARK(trace_begin);
+            const size_t current_tail = tail_.load(std::memory_order_relaxed);
+            const size_t head = head_.load(std::memory_order_acquire);
+            const size_t free_slots = (head - current_tail - 1) & (Capacity - 1);
+            const size_t n = count < free_slots ? count : free_slots;
+
+            for (size_t k = 0; k < n; ++k) {
+                new (&buffer_[(current_tail + k) & (Capacity - 1)]) T(std::move(items[k]));
+            }
+
+            if constexpr (Telemetry::LatencySampleEvery != 0) {
+                producer_telemetry_.stamp(stamps_, current_tail, n, Capacity - 1);
+            }
+
+            if (n != 0) {
+                tail_.store((current_tail + n) & (Capacity - 1), std::memory_order_release);
+                producer_telemetry_.on_push(n, (current_tail + n - head) & (Capacity - 1));
+                FWILLIAMSCA_TRACE_COMPLETE("SPSCRingBuffer::push_bulk", trace_begin);
+            } else if (count != 0) {
+                producer_telemetry_.on_full();
+            }
+            return n;
+        }
+
+        /**
+         * @brief Dequeues up to max_items into out with a single release of head_.
+         * @return Number of items dequeued (0 if buffer is empty).
+         */
+        size_t try_pop_bulk(T* out, size_t max_items) {
+            FWILLIAMSCA_TRACE_MARK(trace_begin);
+            const size_t current_head = head_.load(std::memory_order_relaxed);
+            const size_t tail = tail_.load(std::memory_order_acquire);
+            const size_t available = (tail - current_head) & (Capacity - 1);
+            const size_t n = max_items < available ? max_items : available;
+
+            if constexpr (Telemetry::LatencySampleEvery != 0) {
+                consumer_telemetry_.record_latency(stamps_, current_head, n, Capacity - 1);
+            }
+
+            for (size_t k = 0; k < n; ++k) {
+                T& slot = buffer_[(current_head + k) & (Capacity - 1)];
+                out[k] = std::move(slot);
+                slot.~T();
+            }
+
+            if (n != 0) {
+                head_.store((current_head + n) & (Capacity - 1), std::memory_order_release);
+                consumer_telemetry_.on_pop(n);
+                FWILLIAMSCA_TRACE_COMPLETE("SPSCRingBuffer::pop_bulk", trace_begin);
+            } else if (max_items != 0) {
+                consumer_telemetry_.on_empty();
+            }
+            return n;
+        }
+
+        /**
+         * @brief Consumer-side emptiness check (acquire on tail_).
+         */
+        bool empty() const {
+            return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+        }
+
         /**
          * @brief Prefetches the next cache line into L1 cache.
          * Useful for latency-critical loops.
@@ -102,6 +197,24 @@ namespace memory {
             __builtin_prefetch(&buffer_[next], 0, 3);
         }
 
+        /**
+         * @brief Telemetry counters (all zero with NoRingTelemetry). Safe to
+         * call from any thread; each counter is individually consistent.
+         */
+        RingTelemetrySnapshot telemetry() const {
+            return Telemetry::snapshot(producer_telemetry_, consumer_telemetry_);
+        }
+
+        /**
+         * @brief Sampled enqueue-to-dequeue latency in TSC ticks (policies
+         * with LatencySampleEvery != 0). Consumer thread only: the histogram
+         * is not synchronized; copy or merge() it from the consumer to publish.
+         */
+        const metrics::LatencyHistogram<>& latency() const {
+            static_assert(Telemetry::LatencySampleEvery != 0, "Telemetry policy does not track latency.");
+            return consumer_telemetry_.latency;
+        }
+
     private:
         // PADDING 1: Prevent false sharing with adjacent objects
         char pad0_[CACHE_LINE_SIZE];
@@ -119,6 +232,12 @@ namespace memory {
         char pad2_[CACHE_LINE_SIZE];
 
         T* buffer_;
+        uint64_t* stamps_ = nullptr;    // Push TSC per slot (latency-tracking policies only)
+
+        // Telemetry blocks on lines of their own, written only by their owner,
+        // so counting a failed poll never invalidates the line holding head_/tail_
+        alignas(CACHE_LINE_SIZE) [[no_unique_address]] typename Telemetry::Consumer consumer_telemetry_;
+        alignas(CACHE_LINE_SIZE) [[no_unique_address]] typename Telemetry::Producer producer_telemetry_;
     };
 
 } // namespace memory
@@ -0,0 +1,185 @@
+/**
+ * @file ring_telemetry.h
+ * @brief Opt-in occupancy/stall telemetry policies for SPSCRingBuffer.
+ * * Ring capacity is usually sized by guesswork. With RingTelemetry as the
+ * ring's Telemetry parameter it counts:
+ * - pushes / pops (items) and full / empty failures (calls),
+ * - the high-water mark and a log2 occupancy histogram, sampled on push
+ *   from the producer's view of head_ (an upper bound of the true fill).
+ *
+ * Each side writes only its own block, with plain load+store on
+ * single-writer atomics. The ring places each block on cache lines of its
+ * own, apart from head_ and tail_, so a failed poll never dirties a line the
+ * other thread reads, and no locked RMW is added. A monitoring thread reads
+ * both with snapshot().
+ * The default NoRingTelemetry is empty and compiles away.
+ *
+ * RingLatencyTelemetry<N> additionally measures queueing delay: every Nth
+ * message's slot is stamped with the TSC on push, and the consumer records
+ * now - stamp into a histogram on pop. Both sides count messages in FIFO
+ * order, so they agree on which slots are sampled without any flag in the
+ * slot. Each side counts down to its next sampled message and reads the TSC
+ * only for batches that contain one. Stamps live in a side array owned by
+ * the ring, not inside T.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "../metrics/latency_histogram.h"
+#include "../timing/tsc_clock.h"
+
+namespace fwilliamsca {
+namespace memory {
+
+    struct RingTelemetrySnapshot {
+        // Bucket 0: empty ring; bucket k: occupancy in [2^(k-1), 2^k)
+        static constexpr size_t OccupancyBuckets = 33;
+
+        uint64_t pushes = 0;
+        uint64_t push_full = 0;
+        uint64_t pops = 0;
+        uint64_t pop_empty = 0;
+        uint64_t high_water = 0;
+        std::array<uint64_t, OccupancyBuckets> occupancy{};
+
+        /**
+         * @brief Fraction of push attempts rejected because the ring was full.
+         */
+        double full_ratio() const {
+            const uint64_t attempts = pushes + push_full;
+            return attempts ? static_cast<double>(push_full) / static_cast<double>(attempts) : 0.0;
+        }
+    };
+
+    /**
+     * @brief Default policy: no counters, zero size.
+     */
+    struct NoRingTelemetry {
+        static constexpr size_t LatencySampleEvery = 0;
+
+        struct Producer {
+            void on_push(size_t, size_t) {}
+            void on_full() {}
+        };
+        struct Consumer {
+            void on_pop(size_t) {}
+            void on_empty() {}
+        };
+        static RingTelemetrySnapshot snapshot(const Producer&, const Consumer&) { return {}; }
+    };
+
+    struct RingTelemetry {
+        static constexpr size_t LatencySampleEvery = 0;
+        static constexpr size_t OccupancyBuckets = RingTelemetrySnapshot::OccupancyBuckets;
+
+        // Single-writer counter: plain load+store avoids a locked RMW on the hot path
+        static void bump(std::atomic<uint64_t>& c, uint64_t v = 1) {
+            c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+        }
+
+        static size_t bucket(size_t occupancy) {
+            if (occupancy == 0) return 0;
+            const size_t b = 64 - static_cast<size_t>(__builtin_clzll(occupancy));
+            return b < OccupancyBuckets ? b : OccupancyBuckets - 1;
+        }
+
+        struct Producer {
+            std::atomic<uint64_t> pushes{0};
+            std::atomic<uint64_t> push_full{0};
+            std::atomic<uint64_t> high_water{0};
+            std::array<std::atomic<uint64_t>, OccupancyBuckets> occupancy{};
+
+            /**
+             * @param n Items pushed.
+             * @param occupancy_after Items in the ring after the push.
+             */
+            void on_push(size_t n, size_t occupancy_after) {
+                bump(pushes, n);
+                bump(occupancy[bucket(occupancy_after)]);
+                if (occupancy_after > high_water.load(std::memory_order_relaxed)) {
+                    high_water.store(occupancy_after, std::memory_order_relaxed);
+                }
+            }
+
+            void on_full() { bump(push_full); }
+        };
+
+        struct Consumer {
+            std::atomic<uint64_t> pops{0};
+            std::atomic<uint64_t> pop_empty{0};
+
+            void on_pop(size_t n) { bump(pops, n); }
+            void on_empty() { bump(pop_empty); }
+        };
+
+        static RingTelemetrySnapshot snapshot(const Producer& p, const Consumer& c) {
+            RingTelemetrySnapshot s;
+            s.pushes = p.pushes.load(std::memory_order_relaxed);
+            s.push_full = p.push_full.load(std::memory_order_relaxed);
+            s.high_water = p.high_water.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < OccupancyBuckets; ++i) {
+                s.occupancy[i] = p.occupancy[i].load(std::memory_order_relaxed);
+            }
+            s.pops = c.pops.load(std::memory_order_relaxed);
+            s.pop_empty = c.pop_empty.load(std::memory_order_relaxed);
+            return s;
+        }
+    };
+
+    /**
+     * @brief RingTelemetry plus sampled enqueue-to-dequeue latency (TSC ticks).
+     * SampleEvery = 1 stamps every message.
+     */
+    template <size_t SampleEvery = 64>
+    struct RingLatencyTelemetry : RingTelemetry {
+        static_assert(SampleEvery > 0, "SampleEvery must be non-zero.");
+        static constexpr size_t LatencySampleEvery = SampleEvery;
+
+        struct Producer : RingTelemetry::Producer {
+            size_t next_sample = 0;     // Messages to skip before the next stamped one
+
+            // Called before tail_ is published, so the stamp is visible with the slot
+            void stamp(uint64_t* stamps, size_t first, size_t n, size_t mask) {
+                if (next_sample >= n) {
+                    next_sample -= n;
+                    return;
+                }
+                const uint64_t now = timing::rdtsc();
+                size_t k = next_sample;
+                for (; k < n; k += SampleEvery) stamps[(first + k) & mask] = now;
+                next_sample = k - n;
+            }
+        };
+
+        struct Consumer : RingTelemetry::Consumer {
+            size_t next_sample = 0;     // Mirrors Producer::next_sample in FIFO order
+            metrics::LatencyHistogram<> latency;
+
+            // Called after the acquire of tail_ and before head_ is released
+            void record_latency(const uint64_t* stamps, size_t first, size_t n, size_t mask) {
+                if (next_sample >= n) {
+                    next_sample -= n;
+                    return;
+                }
+                const uint64_t now = timing::rdtsc();
+                size_t k = next_sample;
+                for (; k < n; k += SampleEvery) {
+                    const uint64_t t = stamps[(first + k) & mask];
+                    latency.record(now > t ? now - t : 0);
+                }
+                next_sample = k - n;
+            }
+        };
+
+        static RingTelemetrySnapshot snapshot(const Producer& p, const Consumer& c) {
+            return RingTelemetry::snapshot(p, c);
+        }
+    };
+
+} // namespace memory
+} // namespace fwilliamsca
@@ -0,0 +1,223 @@
+/**
+ * @file latency_histogram.h
+ * @brief Fixed-memory log-linear (HDR-style) histogram for hot-path latencies.
+ * * Storing raw samples at 10M msgs/sec is too expensive; this histogram keeps
+ * one counter per bucket instead:
+ * - Values below 2^SubBucketBits have exact buckets.
+ * - Above that, each power of two is split into 2^SubBucketBits linear
+ *   sub-buckets, so every bucket's width is <= value / 2^SubBucketBits
+ *   (1.6% relative error with the default of 6 bits).
+ * - record() is a CLZ, a shift and an increment: no allocation, no branch
+ *   beyond the small-value/clamp checks.
+ *
+ * Units are whatever the caller records (TSC ticks, ns). Instances are
+ * single-writer; give each thread its own histogram and merge() them for
+ * reporting.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace fwilliamsca {
+namespace metrics {
+
+    template <unsigned SubBucketBits = 6, unsigned MaxValueBits = 40>
+    class LatencyHistogram {
+        static_assert(SubBucketBits >= 1 && SubBucketBits < MaxValueBits, "Invalid bucket geometry.");
+        static_assert(MaxValueBits <= 63, "MaxValueBits must leave headroom in uint64_t.");
+
+    public:
+        static constexpr uint64_t SubBucketCount = uint64_t(1) << SubBucketBits;
+        static constexpr size_t BucketCount = (MaxValueBits - SubBucketBits + 1) * SubBucketCount;
+        static constexpr uint64_t MaxTrackable = (uint64_t(1) << MaxValueBits) - 1;
+
+        /**
+         * @brief Records one value (values above MaxTrackable are clamped).
+         */
+        void record(uint64_t value) {
+            record_n(value, 1);
+        }
+
+        void record_n(uint64_t value, uint64_t count) {
+            const uint64_t v = value < MaxTrackable ? value : MaxTrackable;
+            counts_[bucket_index(v)] += count;
+            total_ += count;
+            sum_ += v * count;
+            min_ = v < min_ ? v : min_;
+            max_ = v > max_ ? v : max_;
+        }
+
+        /**
+         * @brief Adds another histogram's counts into this one.
+         */
+        void merge(const LatencyHistogram& other) {
+            for (size_t i = 0; i < BucketCount; ++i) counts_[i] += other.counts_[i];
+            total_ += other.total_;
+            sum_ += other.sum_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+
+        void reset() {
+            counts_.fill(0);
+            total_ = 0;
+            sum_ = 0;
+            min_ = ~uint64_t(0);
+            max_ = 0;
+        }
+
+        uint64_t count() const { return total_; }
+        uint64_t min() const { return total_ ? min_ : 0; }
+        uint64_t max() const { return max_; }
+        double mean() const { return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0; }
+
+        /**
+         * @brief Smallest recorded-equivalent value v such that at least
+         * percentile% of the samples are <= v (HDR convention).
+         */
+        uint64_t value_at_percentile(double percentile) const {
+            if (total_ == 0) return 0;
+            const double p = std::clamp(percentile, 0.0, 100.0);
+            uint64_t target = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(total_)));
+            if (target == 0) target = 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BucketCount; ++i) {
+                seen += counts_[i];
+                if (seen >= target) {
+                    return std::min(bucket_upper(i), max_);
+                }
+            }
+            return max_;
+        }
+
+        /**
+         * @brief Text summary, e.g. "p50=120 p90=180 ... max=9012 (n=1000000)".
+         * @param scale Multiplier applied to values before printing (e.g. ns per tick).
+         */
+        void print(std::FILE* out, const char* unit = "", double scale = 1.0) const {
+            static constexpr double kPercentiles[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+            static constexpr const char* kLabels[] = {"p50", "p90", "p99", "p99.9", "p99.99"};
+            for (size_t i = 0; i < 5; ++i) {
+                std::fprintf(out, "%s=%.1f%s ", kLabels[i], value_at_percentile(kPercentiles[i]) * scale, unit);
+            }
+            std::fprintf(out, "max=%.1f%s (n=%llu)\n", max() * scale, unit, static_cast<unsigned long long>(total_));
+        }
+
+        /**
+         * @brief Compact binary form: header + varint (index delta, count) pairs
+         * for non-empty buckets. Layout-compatible only with identical
+         * template parameters.
+         */
+        std::string serialize() const {
+            std::string out;
+            put_varint(out, Magic);
+            put_varint(out, SubBucketBits);
+            put_varint(out, MaxValueBits);
+            put_varint(out, total_);
+            put_varint(out, sum_);
+            put_varint(out, min());
+            put_varint(out, max_);
+            size_t last = 0;
+            for (size_t i = 0; i < BucketCount; ++i) {
+                if (counts_[i] == 0) continue;
+                put_varint(out, i - last);
+                put_varint(out, counts_[i]);
+                last = i;
+            }
+            return out;
+        }
+
+        /**
+         * @brief Restores a histogram produced by serialize().
+         * @return false on malformed input or mismatched geometry.
+         */
+        bool deserialize(const std::string& in) {
+            size_t pos = 0;
+            uint64_t magic, sub_bits, max_bits, total, sum, mn, mx;
+            if (!get_varint(in, pos, magic) || magic != Magic) return false;
+            if (!get_varint(in, pos, sub_bits) || sub_bits != SubBucketBits) return false;
+            if (!get_varint(in, pos, max_bits) || max_bits != MaxValueBits) return false;
+            if (!get_varint(in, pos, total) || !get_varint(in, pos, sum) ||
+                !get_varint(in, pos, mn) || !get_varint(in, pos, mx)) {
+                return false;
+            }
+            reset();
+            uint64_t index = 0;
+            while (pos < in.size()) {
+                uint64_t delta, count;
+                if (!get_varint(in, pos, delta) || !get_varint(in, pos, count)) return false;
+                index += delta;
+                if (index >= BucketCount) return false;
+                counts_[index] = count;
+            }
+            total_ = total;
+            sum_ = sum;
+            min_ = total ? mn : ~uint64_t(0);
+            max_ = mx;
+            return true;
+        }
+
+        // Bucket geometry (exposed for tests and exporters)
+        static size_t bucket_index(uint64_t v) {
+            if (v < SubBucketCount) return static_cast<size_t>(v);
+            const unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(v));
+            const unsigned shift = msb - SubBucketBits;
+            return static_cast<size_t>(shift) * SubBucketCount + static_cast<size_t>(v >> shift);
+        }
+
+        static uint64_t bucket_lower(size_t index) {
+            if (index < SubBucketCount) return index;
+            const unsigned shift = static_cast<unsigned>(index / SubBucketCount) - 1;
+            return (SubBucketCount + index % SubBucketCount) << shift;
+        }
+
+        static uint64_t bucket_upper(size_t index) {
+            if (index < SubBucketCount) return index;
+            const unsigned shift = static_cast<unsigned>(index / SubBucketCount) - 1;
+            return bucket_lower(index) + (uint64_t(1) << shift) - 1;
+        }
+
+        // Unbiased representative of a bucket's values (bucket_lower() undershoots by up to its width)
+        static double bucket_midpoint(size_t index) {
+            return 0.5 * (static_cast<double>(bucket_lower(index)) + static_cast<double>(bucket_upper(index)));
+        }
+
+        uint64_t bucket_count(size_t index) const { return counts_[index]; }
+
+    private:
+        static constexpr uint64_t Magic = 0x4857484C; // "LHWH"
+
+        static void put_varint(std::string& out, uint64_t v) {
+            while (v >= 0x80) {
+                out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<char>(v));
+        }
+
+        static bool get_varint(const std::string& in, size_t& pos, uint64_t& v) {
+            v = 0;
+            for (unsigned shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+                const uint8_t byte = static_cast<uint8_t>(in[pos++]);
+                v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) return true;
+            }
+            return false;
+        }
+
+        std::array<uint64_t, BucketCount> counts_{};
+        uint64_t total_ = 0;
+        uint64_t sum_ = 0;
+        uint64_t min_ = ~uint64_t(0);
+        uint64_t max_ = 0;
+    };
+
+} // namespace metrics
+} // namespace fwilliamsca
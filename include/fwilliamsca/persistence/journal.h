@@ -0,0 +1,526 @@
+/**
+ * @file journal.h
+ * @brief Memory-mapped, segmented message journal for compliance and replay.
+ * * The strategy thread only pushes into an SPSCRingBuffer; a journaling
+ * consumer (RingJournaler) drains the ring into pre-allocated, mmap'd
+ * segment files, so persistence adds no syscall to the producer.
+ *
+ * On-disk layout (little-endian, one file per segment):
+ *   <dir>/<name>.<index:06>.journal
+ *   [SegmentHeader: 64 bytes]
+ *   [RecordHeader{length, flags, tsc}][payload][pad to 8] ...
+ *   A zero length marks the end of written data; RollMarker marks a segment
+ *   that was closed because the next record did not fit.
+ *
+ * Records are published by storing the length last (release), so a reader
+ * tailing a live journal never observes a partially written payload. The
+ * same rule lets a restarted writer resume: it appends after the last
+ * published record of the highest existing segment.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <immintrin.h>
+
+#include "../concurrency/affinity.h"
+#include "../timing/tsc_clock.h"
+
+namespace fwilliamsca {
+namespace persistence {
+
+    inline constexpr uint64_t JournalMagic = 0x314C4E524A5746ull; // "FWJRNL1"
+    inline constexpr uint32_t JournalVersion = 1;
+
+    struct alignas(64) SegmentHeader {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t index;
+        uint64_t segment_size;
+        uint64_t created_tsc;
+    };
+    static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader must occupy one cache line.");
+
+    struct RecordHeader {
+        uint32_t length;    // Payload bytes; 0 = end of data, RollMarker = segment closed
+        uint32_t flags;     // Reserved (user tag)
+        uint64_t tsc;       // rdtsc at enqueue (element's tsc member) or append time
+    };
+    static_assert(sizeof(RecordHeader) == 16, "RecordHeader layout is part of the file format.");
+
+    inline constexpr uint32_t RollMarker = 0xFFFFFFFFu;
+
+    namespace detail {
+
+        inline size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+        inline std::string segment_path(const std::string& dir, const std::string& name, uint32_t index) {
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), ".%06u.journal", index);
+            return (std::filesystem::path(dir) / (name + suffix)).string();
+        }
+
+        enum class SegmentMode {
+            Read,       // Existing file, read-only
+            Create,     // New file of the given size; fails if it already exists
+            Append      // Existing file, read-write
+        };
+
+        /**
+         * @brief One mmap'd segment file (RAII).
+         */
+        class MappedSegment {
+        public:
+            MappedSegment() = default;
+
+            MappedSegment(const std::string& path, size_t size, SegmentMode mode, bool prefault) {
+                const bool create = mode == SegmentMode::Create;
+                const bool writable = mode != SegmentMode::Read;
+                // O_EXCL: never truncate records another writer (or an earlier run) left behind
+                const int flags = create ? (O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC)
+                                         : ((writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+                fd_ = open(path.c_str(), flags, 0644);
+                if (fd_ < 0) {
+                    throw std::system_error(errno, std::generic_category(), "open " + path);
+                }
+                if (create) {
+                    const int rc = posix_fallocate(fd_, 0, static_cast<off_t>(size));
+                    if (rc != 0) {
+                        close(fd_);
+                        throw std::system_error(rc, std::generic_category(), "posix_fallocate " + path);
+                    }
+                } else {
+                    struct stat st;
+                    if (fstat(fd_, &st) != 0) {
+                        const int err = errno;
+                        close(fd_);
+                        throw std::system_error(err, std::generic_category(), "fstat " + path);
+                    }
+                    size = static_cast<size_t>(st.st_size);
+                }
+                const int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+                const int mflags = MAP_SHARED | (prefault ? MAP_POPULATE : 0);
+                void* p = mmap(nullptr, size, prot, mflags, fd_, 0);
+                if (p == MAP_FAILED) {
+                    const int err = errno;
+                    close(fd_);
+                    throw std::system_error(err, std::generic_category(), "mmap " + path);
+                }
+                base_ = static_cast<char*>(p);
+                size_ = size;
+            }
+
+            ~MappedSegment() { reset(); }
+
+            MappedSegment(MappedSegment&& o) noexcept
+                : base_(std::exchange(o.base_, nullptr)), size_(std::exchange(o.size_, 0)),
+                  fd_(std::exchange(o.fd_, -1)) {}
+
+            MappedSegment& operator=(MappedSegment&& o) noexcept {
+                if (this != &o) {
+                    reset();
+                    base_ = std::exchange(o.base_, nullptr);
+                    size_ = std::exchange(o.size_, 0);
+                    fd_ = std::exchange(o.fd_, -1);
+                }
+                return *this;
+            }
+
+            void reset() {
+                if (base_) munmap(base_, size_);
+                if (fd_ >= 0) close(fd_);
+                base_ = nullptr;
+                size_ = 0;
+                fd_ = -1;
+            }
+
+            void sync(bool blocking) {
+                if (base_) msync(base_, size_, blocking ? MS_SYNC : MS_ASYNC);
+            }
+
+            char* data() const { return base_; }
+            size_t size() const { return size_; }
+            explicit operator bool() const { return base_ != nullptr; }
+
+        private:
+            char* base_ = nullptr;
+            size_t size_ = 0;
+            int fd_ = -1;
+        };
+
+        inline uint32_t load_length(const char* p) {
+            return std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(const_cast<char*>(p)))
+                .load(std::memory_order_acquire);
+        }
+
+        inline void store_length(char* p, uint32_t length) {
+            std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(p)).store(length, std::memory_order_release);
+        }
+
+        // Enqueue-time timestamp when the ring element carries one, else now
+        template <typename T>
+        inline uint64_t record_tsc(const T& value, uint64_t now) {
+            if constexpr (requires { static_cast<uint64_t>(value.tsc); }) return static_cast<uint64_t>(value.tsc);
+            else return now;
+        }
+
+    } // namespace detail
+
+    struct JournalConfig {
+        std::string directory = ".";
+        std::string name = "journal";
+        size_t segment_size = size_t(64) << 20;  // Bytes per segment file (incl. header)
+        bool prefault = true;                    // MAP_POPULATE: no page faults on the first append
+    };
+
+    /**
+     * @brief Appends length-prefixed, timestamped records to rolling segments.
+     * Single-threaded: owned by the journaling consumer. On an existing
+     * journal it resumes after the last record of the highest segment.
+     */
+    class JournalWriter {
+    public:
+        explicit JournalWriter(JournalConfig cfg) : cfg_(std::move(cfg)) {
+            if (cfg_.segment_size < sizeof(SegmentHeader) + 2 * sizeof(RecordHeader)) {
+                throw std::invalid_argument("JournalWriter: segment_size too small");
+            }
+            std::filesystem::create_directories(cfg_.directory);
+            uint32_t last = 0;
+            while (std::filesystem::exists(detail::segment_path(cfg_.directory, cfg_.name, last + 1))) ++last;
+            if (std::filesystem::exists(detail::segment_path(cfg_.directory, cfg_.name, last))) {
+                resume_segment(last);
+            } else {
+                open_segment(0);
+            }
+        }
+
+        ~JournalWriter() { flush(false); }
+
+        JournalWriter(const JournalWriter&) = delete;
+        JournalWriter& operator=(const JournalWriter&) = delete;
+
+        /**
+         * @brief Largest payload that fits in one segment.
+         */
+        size_t max_payload() const {
+            return (cfg_.segment_size - sizeof(SegmentHeader) - 2 * sizeof(RecordHeader)) & ~size_t(7);
+        }
+
+        /**
+         * @brief Appends one record, rolling to a new segment when full.
+         * @throws std::length_error if len exceeds max_payload().
+         */
+        void append(const void* data, uint32_t len, uint64_t tsc = __rdtsc(), uint32_t flags = 0) {
+            if (len > max_payload()) {
+                throw std::length_error("JournalWriter: record larger than a segment");
+            }
+            const size_t needed = sizeof(RecordHeader) + detail::align8(len);
+            // Always keep room for a trailing RecordHeader (end or roll marker)
+            if (offset_ + needed + sizeof(RecordHeader) > segment_.size()) {
+                roll();
+            }
+
+            char* rec = segment_.data() + offset_;
+            RecordHeader* hdr = reinterpret_cast<RecordHeader*>(rec);
+            hdr->flags = flags;
+            hdr->tsc = tsc;
+            std::memcpy(rec + sizeof(RecordHeader), data, len);
+            detail::store_length(rec, len);  // Publish last
+
+            offset_ += needed;
+            ++records_;
+        }
+
+        template <typename T>
+        void append(const T& value, uint64_t tsc = __rdtsc()) {
+            static_assert(std::is_trivially_copyable_v<T>, "Journal payloads must be trivially copyable.");
+            append(&value, static_cast<uint32_t>(sizeof(T)), tsc);
+        }
+
+        /**
+         * @brief Drains up to max_items from an SPSC ring into the journal.
+         * Each record is stamped with the element's own `tsc` member when it
+         * has one (taken by the producer at enqueue), which is what
+         * ReplaySpeed::Original reproduces; otherwise with the drain time,
+         * shared by the whole popped batch.
+         * @return Number of records appended.
+         */
+        template <typename Ring>
+        size_t drain(Ring& ring, size_t max_items = 64) {
+            using T = typename Ring::value_type;
+            T batch[64];
+            size_t total = 0;
+            while (total < max_items) {
+                const size_t want = (max_items - total) < 64 ? (max_items - total) : 64;
+                const size_t n = ring.try_pop_bulk(batch, want);
+                if (n == 0) break;
+                const uint64_t tsc = __rdtsc();
+                for (size_t k = 0; k < n; ++k) append(batch[k], detail::record_tsc(batch[k], tsc));
+                total += n;
+            }
+            return total;
+        }
+
+        /**
+         * @brief Schedules (or, if blocking, waits for) write-back of the active segment.
+         */
+        void flush(bool blocking = false) { segment_.sync(blocking); }
+
+        uint32_t segment_index() const { return index_; }
+        uint64_t records() const { return records_; }   // Appended by this writer (excludes resumed ones)
+
+    private:
+        void open_segment(uint32_t index) {
+            segment_ = detail::MappedSegment(detail::segment_path(cfg_.directory, cfg_.name, index),
+                                             cfg_.segment_size, detail::SegmentMode::Create, cfg_.prefault);
+            SegmentHeader* sh = reinterpret_cast<SegmentHeader*>(segment_.data());
+            sh->magic = JournalMagic;
+            sh->version = JournalVersion;
+            sh->index = index;
+            sh->segment_size = cfg_.segment_size;
+            sh->created_tsc = __rdtsc();
+            index_ = index;
+            offset_ = sizeof(SegmentHeader);
+        }
+
+        // Reopens an existing segment at its end of data; a closed one rolls to the next index
+        void resume_segment(uint32_t index) {
+            const std::string path = detail::segment_path(cfg_.directory, cfg_.name, index);
+            segment_ = detail::MappedSegment(path, 0, detail::SegmentMode::Append, cfg_.prefault);
+            const SegmentHeader* sh = reinterpret_cast<const SegmentHeader*>(segment_.data());
+            if (segment_.size() < sizeof(SegmentHeader) + sizeof(RecordHeader) || sh->magic != JournalMagic ||
+                sh->version != JournalVersion || sh->index != index) {
+                throw std::runtime_error("JournalWriter: bad segment header in " + path);
+            }
+            index_ = index;
+            offset_ = sizeof(SegmentHeader);
+            for (;;) {
+                const uint32_t len = detail::load_length(segment_.data() + offset_);
+                if (len == 0) return;
+                if (len == RollMarker) {
+                    open_segment(index + 1);
+                    return;
+                }
+                const size_t next = offset_ + sizeof(RecordHeader) + detail::align8(len);
+                if (next + sizeof(RecordHeader) > segment_.size()) {
+                    throw std::runtime_error("JournalWriter: corrupt record in " + path);
+                }
+                offset_ = next;
+            }
+        }
+
+        void roll() {
+            detail::store_length(segment_.data() + offset_, RollMarker);
+            segment_.sync(false);
+            open_segment(index_ + 1);
+        }
+
+        JournalConfig cfg_;
+        detail::MappedSegment segment_;
+        uint32_t index_ = 0;
+        size_t offset_ = 0;
+        uint64_t records_ = 0;
+    };
+
+    /**
+     * @brief Owns a thread that drains a ring into a JournalWriter.
+     */
+    template <typename Ring>
+    class RingJournaler {
+    public:
+        RingJournaler(Ring& ring, JournalConfig cfg, int core = -1)
+            : ring_(ring), writer_(std::move(cfg)), core_(core) {}
+
+        ~RingJournaler() { stop(); }
+
+        void start() {
+            stop_.store(false, std::memory_order_relaxed);
+            thread_ = std::thread([this]() {
+                concurrency::name_current_thread("journal");
+                if (core_ >= 0) concurrency::pin_current_thread(core_);
+                for (;;) {
+                    if (writer_.drain(ring_, 256) != 0) continue;
+                    if (stop_.load(std::memory_order_acquire) && ring_.empty()) break;
+                    std::this_thread::yield();
+                }
+                writer_.flush(true);
+            });
+        }
+
+        /**
+         * @brief Drains whatever is left in the ring, syncs and joins.
+         */
+        void stop() {
+            if (!thread_.joinable()) return;
+            stop_.store(true, std::memory_order_release);
+            thread_.join();
+        }
+
+        const JournalWriter& writer() const { return writer_; }
+
+    private:
+        Ring& ring_;
+        JournalWriter writer_;
+        int core_;
+        std::atomic<bool> stop_{false};
+        std::thread thread_;
+    };
+
+    /**
+     * @brief A record as seen by the reader (points into the mapping).
+     */
+    struct JournalRecord {
+        uint64_t tsc;
+        uint32_t flags;
+        uint32_t length;
+        const char* data;
+
+        /**
+         * @brief Copies the payload into out.
+         * @return false (out untouched) if the record is shorter than T.
+         */
+        template <typename T>
+        bool as(T& out) const {
+            static_assert(std::is_trivially_copyable_v<T>, "Journal payloads must be trivially copyable.");
+            if (length < sizeof(T)) return false;
+            std::memcpy(&out, data, sizeof(T));
+            return true;
+        }
+    };
+
+    enum class ReplaySpeed {
+        Original,   // Reproduce the recorded TSC deltas: arrival gaps if records carry an enqueue tsc (see drain)
+        Max         // Push as fast as the ring accepts
+    };
+
+    /**
+     * @brief Sequential reader over a journal's segments.
+     */
+    class JournalReader {
+    public:
+        JournalReader(std::string directory, std::string name)
+            : dir_(std::move(directory)), name_(std::move(name)) {
+            open_segment(0);
+        }
+
+        /**
+         * @brief Advances to the next record.
+         * @return false at the end of the journal (or of written data).
+         */
+        bool next(JournalRecord& out) {
+            while (segment_) {
+                if (offset_ + sizeof(RecordHeader) <= segment_.size()) {
+                    const char* rec = segment_.data() + offset_;
+                    const uint32_t len = detail::load_length(rec);
+                    if (len == 0) return false;
+                    if (len != RollMarker) {
+                        // A length running past the mapping is a torn or foreign file, not data
+                        if (len > segment_.size() - offset_ - sizeof(RecordHeader)) {
+                            throw std::runtime_error("JournalReader: corrupt record in " +
+                                                     detail::segment_path(dir_, name_, index_));
+                        }
+                        const RecordHeader* hdr = reinterpret_cast<const RecordHeader*>(rec);
+                        out.tsc = hdr->tsc;
+                        out.flags = hdr->flags;
+                        out.length = len;
+                        out.data = rec + sizeof(RecordHeader);
+                        offset_ += sizeof(RecordHeader) + detail::align8(len);
+                        return true;
+                    }
+                }
+                if (!open_segment(index_ + 1)) return false;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Replays every remaining record of type T into ring.
+         * At ReplaySpeed::Original the gap to the previous record is
+         * reproduced in TSC ticks (meaningful on hosts with the same invariant
+         * TSC rate). A tsc that goes backwards (records stamped on another
+         * socket, a host reboot between segments) replays with no gap, and
+         * gaps longer than max_gap, such as a writer restarted overnight, are
+         * shortened to it. A record shorter than T throws.
+         * @return Number of records pushed.
+         */
+        template <typename Ring>
+        size_t replay(Ring& ring, ReplaySpeed speed = ReplaySpeed::Max,
+                      std::chrono::nanoseconds max_gap = std::chrono::seconds(1)) {
+            using T = typename Ring::value_type;
+            JournalRecord rec;
+            size_t count = 0;
+            uint64_t prev_tsc = 0;
+            uint64_t due = 0;
+            const uint64_t max_gap_ticks = speed == ReplaySpeed::Original
+                ? timing::TscClock::instance().from_ns(static_cast<double>(max_gap.count()))
+                : 0;
+            while (next(rec)) {
+                if (speed == ReplaySpeed::Original) {
+                    if (count == 0) {
+                        due = __rdtsc();
+                    } else {
+                        const uint64_t delta = rec.tsc > prev_tsc ? rec.tsc - prev_tsc : 0;
+                        due += delta < max_gap_ticks ? delta : max_gap_ticks;
+                    }
+                    prev_tsc = rec.tsc;
+                    while (__rdtsc() < due) _mm_pause();
+                }
+                T value;
+                if (!rec.as(value)) {
+                    throw std::runtime_error("JournalReader: short record in " +
+                                             detail::segment_path(dir_, name_, index_));
+                }
+                while (!ring.try_push(std::move(value))) _mm_pause();
+                ++count;
+            }
+            return count;
+        }
+
+        uint32_t segment_index() const { return index_; }
+
+    private:
+        bool open_segment(uint32_t index) {
+            const std::string path = detail::segment_path(dir_, name_, index);
+            if (!std::filesystem::exists(path)) {
+                segment_.reset();
+                return false;
+            }
+            segment_ = detail::MappedSegment(path, 0, detail::SegmentMode::Read, false);
+            const SegmentHeader* sh = reinterpret_cast<const SegmentHeader*>(segment_.data());
+            if (segment_.size() < sizeof(SegmentHeader) || sh->magic != JournalMagic ||
+                sh->version != JournalVersion) {
+                throw std::runtime_error("JournalReader: bad segment header in " + path);
+            }
+            index_ = index;
+            offset_ = sizeof(SegmentHeader);
+            return true;
+        }
+
+        std::string dir_;
+        std::string name_;
+        detail::MappedSegment segment_;
+        uint32_t index_ = 0;
+        size_t offset_ = 0;
+    };
+
+} // namespace persistence
+} // namespace fwilliamsca
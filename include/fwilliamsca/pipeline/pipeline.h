@@ -0,0 +1,378 @@
+/**
+ * @file pipeline.h
+ * @brief Stage-graph builder for thread chains linked by SPSCRingBuffers.
+ * * A tick-to-trade path is a chain of stages (decode, book build, signal,
+ * risk, encode). Each stage added to a Pipeline owns one (optionally
+ * pinned) thread; consecutive steps that should share a thread are
+ * composed with fuse(). Moving a ring boundary is therefore a one-line
+ * change, which makes fusing/splitting stages cheap to evaluate.
+ * - Messages are handed off in batches (try_pop_bulk / try_push_bulk).
+ * - A full output ring is handled by a per-stage BackPressure policy.
+ * - Per-stage counters (messages, drops, stalls, busy cycles) live on the
+ *   stage's own cache line and can be snapshotted from any thread.
+ * - Each batch is a trace span named after its stage (FWILLIAMSCA_TRACE).
+ * - Type erasure happens once at thread start; the per-message loop is
+ *   fully inlined (no virtual dispatch).
+ *
+ * Step signatures:
+ *   transform : bool(In& in, Out& out)  -- return false to filter the message
+ *   source    : bool(Out& out)          -- return false when nothing produced
+ *   sink      : void(In& in)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "../concurrency/affinity.h"
+#include "../trace/trace.h"
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+namespace fwilliamsca {
+namespace pipeline {
+
+    /**
+     * @brief What a stage does when its output ring is full.
+     */
+    enum class BackPressure {
+        Spin,   // Busy-wait with PAUSE until space frees up (lossless)
+        Yield,  // std::this_thread::yield() between retries (lossless)
+        Drop    // Discard the message and count it (lossy, never blocks)
+    };
+
+    struct StageConfig {
+        int core = -1;                          // Logical CPU to pin to (-1: unpinned)
+        BackPressure back_pressure = BackPressure::Spin;
+        size_t idle_spins = 1024;               // Empty polls before yielding the CPU (0: never yield)
+    };
+
+    /**
+     * @brief Point-in-time copy of a stage's counters.
+     */
+    struct StageStats {
+        uint64_t messages_in = 0;       // Messages taken from the input ring (or produced by a source)
+        uint64_t messages_out = 0;      // Messages delivered to the output ring
+        uint64_t filtered = 0;          // Messages a step returned false for
+        uint64_t dropped = 0;           // Messages discarded by BackPressure::Drop
+        uint64_t stalls = 0;            // Batches that found the output ring full
+        uint64_t batches = 0;           // Non-empty batches processed
+        uint64_t busy_cycles = 0;       // TSC cycles spent processing batches (excl. idle polling)
+        uint64_t max_batch_cycles = 0;  // Worst single batch
+
+        double cycles_per_message() const {
+            return messages_in ? static_cast<double>(busy_cycles) / messages_in : 0.0;
+        }
+    };
+
+    namespace detail {
+
+        // Deduces In/Out from a non-generic callable bool(In&, Out&)
+        template <typename F>
+        struct step_traits : step_traits<decltype(&std::remove_cvref_t<F>::operator())> {};
+
+        template <typename R, typename A, typename B>
+        struct step_traits<R (*)(A, B)> {
+            using in_type = std::remove_cvref_t<A>;
+            using out_type = std::remove_cvref_t<B>;
+        };
+
+        template <typename C, typename R, typename A, typename B>
+        struct step_traits<R (C::*)(A, B)> : step_traits<R (*)(A, B)> {};
+
+        template <typename C, typename R, typename A, typename B>
+        struct step_traits<R (C::*)(A, B) const> : step_traits<R (*)(A, B)> {};
+
+        template <typename F, typename G>
+        struct Fused {
+            using mid_type = typename step_traits<F>::out_type;
+            F first;
+            G second;
+
+            template <typename In, typename Out>
+            bool operator()(In& in, Out& out) {
+                mid_type mid;
+                return first(in, mid) && second(mid, out);
+            }
+        };
+
+        template <typename F, typename G>
+        struct step_traits<Fused<F, G>> {
+            using in_type = typename step_traits<F>::in_type;
+            using out_type = typename step_traits<G>::out_type;
+        };
+
+        // Single-writer counter: plain load+store avoids a locked RMW on the hot path
+        inline void bump(std::atomic<uint64_t>& c, uint64_t v = 1) {
+            c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+        }
+
+        struct alignas(CACHE_LINE_SIZE) StageControl {
+            std::atomic<bool> stop{false};
+            std::atomic<uint64_t> messages_in{0};
+            std::atomic<uint64_t> messages_out{0};
+            std::atomic<uint64_t> filtered{0};
+            std::atomic<uint64_t> dropped{0};
+            std::atomic<uint64_t> stalls{0};
+            std::atomic<uint64_t> batches{0};
+            std::atomic<uint64_t> busy_cycles{0};
+            std::atomic<uint64_t> max_batch_cycles{0};
+            uint32_t trace_id = 0;          // Stage name as a trace event (FWILLIAMSCA_TRACE builds)
+
+            void record_batch(uint64_t begin_tsc) {
+                const uint64_t cycles = __rdtsc() - begin_tsc;
+                FWILLIAMSCA_TRACE_COMPLETE_ID(trace_id, begin_tsc);
+                bump(batches);
+                bump(busy_cycles, cycles);
+                if (cycles > max_batch_cycles.load(std::memory_order_relaxed)) {
+                    max_batch_cycles.store(cycles, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        inline void idle(size_t& idle_count, size_t idle_spins) {
+            if (idle_spins != 0 && ++idle_count >= idle_spins) {
+                idle_count = 0;
+                std::this_thread::yield();
+            } else {
+                _mm_pause();
+            }
+        }
+
+        // Pushes out[0, n) honouring the back-pressure policy.
+        template <typename OutRing>
+        void deliver(OutRing& ring, typename OutRing::value_type* out, size_t n,
+                     BackPressure policy, StageControl& ctl) {
+            size_t sent = 0;
+            bool stalled = false;
+            while (sent < n) {
+                const size_t pushed = ring.try_push_bulk(out + sent, n - sent);
+                sent += pushed;
+                if (sent == n) break;
+
+                if (!stalled) {
+                    bump(ctl.stalls);
+                    stalled = true;
+                }
+                if (policy == BackPressure::Drop) {
+                    bump(ctl.dropped, n - sent);
+                    break;
+                }
+                if (policy == BackPressure::Yield) {
+                    std::this_thread::yield();
+                } else {
+                    _mm_pause();
+                }
+            }
+            bump(ctl.messages_out, sent);
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Composes steps so they run back-to-back in one thread.
+     * fuse(a, b, c) is equivalent to fuse(fuse(a, b), c).
+     */
+    template <typename F, typename G>
+    auto fuse(F&& f, G&& g) {
+        return detail::Fused<std::decay_t<F>, std::decay_t<G>>{std::forward<F>(f), std::forward<G>(g)};
+    }
+
+    template <typename F, typename G, typename H, typename... Rest>
+    auto fuse(F&& f, G&& g, H&& h, Rest&&... rest) {
+        return fuse(fuse(std::forward<F>(f), std::forward<G>(g)),
+                    std::forward<H>(h), std::forward<Rest>(rest)...);
+    }
+
+    /**
+     * @brief Owns the stage threads of one pipeline.
+     * @tparam BatchSize Maximum messages moved per ring hand-off.
+     *
+     * Stages are started together by start() and stopped by stop() in the
+     * order they were added: a stage exits once it is told to stop and its
+     * input ring is empty. Add stages upstream-first so that stop() drains
+     * every in-flight message.
+     */
+    template <size_t BatchSize = 32>
+    class Pipeline {
+        static_assert(BatchSize > 0, "BatchSize must be non-zero.");
+
+    public:
+        Pipeline() = default;
+        ~Pipeline() { stop(); }
+
+        Pipeline(const Pipeline&) = delete;
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        /**
+         * @brief Adds a stage: pop from in, apply step, push to out.
+         * @return Stage index (for stats()).
+         */
+        template <typename InRing, typename OutRing, typename Step>
+        size_t add_stage(std::string name, InRing& in, OutRing& out, Step step, StageConfig cfg = {}) {
+            using In = typename InRing::value_type;
+            using Out = typename OutRing::value_type;
+            return add(std::move(name), cfg, [&in, &out, step = std::move(step), cfg](detail::StageControl& ctl) mutable {
+                In inputs[BatchSize];
+                Out outputs[BatchSize];
+                size_t idle_count = 0;
+                for (;;) {
+                    const size_t n = in.try_pop_bulk(inputs, BatchSize);
+                    if (n == 0) {
+                        if (ctl.stop.load(std::memory_order_acquire)) return;
+                        detail::idle(idle_count, cfg.idle_spins);
+                        continue;
+                    }
+                    const uint64_t t0 = __rdtsc();
+                    size_t produced = 0;
+                    for (size_t k = 0; k < n; ++k) {
+                        if (step(inputs[k], outputs[produced])) ++produced;
+                    }
+                    detail::deliver(out, outputs, produced, cfg.back_pressure, ctl);
+                    detail::bump(ctl.messages_in, n);
+                    detail::bump(ctl.filtered, n - produced);
+                    ctl.record_batch(t0);
+                }
+            });
+        }
+
+        /**
+         * @brief Adds a source stage that polls step(out) until stopped.
+         */
+        template <typename OutRing, typename Step>
+        size_t add_source(std::string name, OutRing& out, Step step, StageConfig cfg = {}) {
+            using Out = typename OutRing::value_type;
+            return add(std::move(name), cfg, [&out, step = std::move(step), cfg](detail::StageControl& ctl) mutable {
+                Out outputs[BatchSize];
+                size_t idle_count = 0;
+                while (!ctl.stop.load(std::memory_order_acquire)) {
+                    const uint64_t t0 = __rdtsc();
+                    size_t produced = 0;
+                    while (produced < BatchSize && step(outputs[produced])) ++produced;
+                    if (produced == 0) {
+                        detail::idle(idle_count, cfg.idle_spins);
+                        continue;
+                    }
+                    detail::deliver(out, outputs, produced, cfg.back_pressure, ctl);
+                    detail::bump(ctl.messages_in, produced);
+                    ctl.record_batch(t0);
+                }
+            });
+        }
+
+        /**
+         * @brief Adds a terminal stage that consumes from in.
+         */
+        template <typename InRing, typename Step>
+        size_t add_sink(std::string name, InRing& in, Step step, StageConfig cfg = {}) {
+            using In = typename InRing::value_type;
+            return add(std::move(name), cfg, [&in, step = std::move(step), cfg](detail::StageControl& ctl) mutable {
+                In inputs[BatchSize];
+                size_t idle_count = 0;
+                for (;;) {
+                    const size_t n = in.try_pop_bulk(inputs, BatchSize);
+                    if (n == 0) {
+                        if (ctl.stop.load(std::memory_order_acquire)) return;
+                        detail::idle(idle_count, cfg.idle_spins);
+                        continue;
+                    }
+                    const uint64_t t0 = __rdtsc();
+                    for (size_t k = 0; k < n; ++k) step(inputs[k]);
+                    detail::bump(ctl.messages_in, n);
+                    ctl.record_batch(t0);
+                }
+            });
+        }
+
+        /**
+         * @brief Launches every stage thread.
+         */
+        void start() {
+            for (auto& stage : stages_) {
+                if (stage->thread.joinable()) continue;
+                stage->control->stop.store(false, std::memory_order_relaxed);
+                stage->thread = std::thread([s = stage.get()]() {
+                    concurrency::name_current_thread(s->name.c_str());
+#if defined(FWILLIAMSCA_TRACE)
+                    trace::set_thread_name(s->name);
+                    s->control->trace_id = trace::register_event(s->name);
+#endif
+                    if (s->config.core >= 0) {
+                        concurrency::pin_current_thread(s->config.core);
+                    }
+                    s->body(*s->control);
+                });
+            }
+        }
+
+        /**
+         * @brief Stops and joins stages in insertion order (upstream first).
+         */
+        void stop() {
+            for (auto& stage : stages_) {
+                if (!stage->thread.joinable()) continue;
+                stage->control->stop.store(true, std::memory_order_release);
+                stage->thread.join();
+            }
+        }
+
+        size_t num_stages() const { return stages_.size(); }
+
+        const std::string& name(size_t stage) const { return stages_[stage]->name; }
+
+        /**
+         * @brief Snapshot of a stage's counters (safe from any thread).
+         */
+        StageStats stats(size_t stage) const {
+            const detail::StageControl& c = *stages_[stage]->control;
+            StageStats s;
+            s.messages_in = c.messages_in.load(std::memory_order_relaxed);
+            s.messages_out = c.messages_out.load(std::memory_order_relaxed);
+            s.filtered = c.filtered.load(std::memory_order_relaxed);
+            s.dropped = c.dropped.load(std::memory_order_relaxed);
+            s.stalls = c.stalls.load(std::memory_order_relaxed);
+            s.batches = c.batches.load(std::memory_order_relaxed);
+            s.busy_cycles = c.busy_cycles.load(std::memory_order_relaxed);
+            s.max_batch_cycles = c.max_batch_cycles.load(std::memory_order_relaxed);
+            return s;
+        }
+
+    private:
+        struct Stage {
+            std::string name;
+            StageConfig config;
+            std::function<void(detail::StageControl&)> body;
+            std::unique_ptr<detail::StageControl> control;   // Own allocation: cache-line aligned
+            std::thread thread;
+        };
+
+        template <typename Body>
+        size_t add(std::string name, StageConfig cfg, Body&& body) {
+            auto stage = std::make_unique<Stage>();
+            stage->name = std::move(name);
+            stage->config = cfg;
+            stage->body = std::forward<Body>(body);
+            stage->control = std::make_unique<detail::StageControl>();
+            stages_.push_back(std::move(stage));
+            return stages_.size() - 1;
+        }
+
+        // Heap-allocated so running threads keep valid pointers as stages are added
+        std::vector<std::unique_ptr<Stage>> stages_;
+    };
+
+} // namespace pipeline
+} // namespace fwilliamsca
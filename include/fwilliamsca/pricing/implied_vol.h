@@ -0,0 +1,146 @@
+/**
+ * @file implied_vol.h
+ * @brief Batched implied-volatility inversion with per-lane convergence.
+ * * A scalar Newton/Brent loop runs a different number of iterations per
+ * option, so it cannot be unrolled across SIMD lanes. Here a register of
+ * options (8 on AVX512_F, 4 on AVX2/AVX512_VL) iterates together: each
+ * lane keeps its own bracket and an active mask, converged lanes freeze,
+ * and the register finishes when every lane has converged or after
+ * max_iterations.
+ *
+ * Per lane:
+ * - In-the-money options are solved as their out-of-the-money parity twin
+ *   (same vol, no intrinsic value to cancel against).
+ * - The starting point is the Corrado-Miller closed form, or the caller's
+ *   previous vols (warm start from the last tick).
+ * - Newton steps on log(price) in vol use vega. A step that leaves the
+ *   bracket [lo, hi] (price is increasing in vol) becomes a bisection, so
+ *   deep out-of-the-money lanes cannot diverge.
+ * - Prices outside the no-arbitrage bounds, T <= 0 or non-finite inputs
+ *   give NaN, as do lanes still unconverged at max_iterations.
+ *
+ * A register costs as many iterations as its slowest lane: on a chain of
+ * strikes +-30% around spot, about 5.5 per register from the closed form
+ * and 3 from a warm start within 1% of the answer. Deep in-the-money
+ * options whose time value is below double precision of the price come
+ * back NaN: no vol is better determined than another.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+
+#include "black_scholes.h"
+
+namespace fwilliamsca {
+namespace pricing {
+
+    namespace detail {
+
+        constexpr double Pi = 3.14159265358979323846264338328;
+        constexpr double Sqrt2Pi = 2.50662827463100050241576528481;
+
+    } // namespace detail
+
+    struct ImpliedVolConfig {
+        int max_iterations = 32;
+        // Converged once a step moves vol by less than this. Newton is quadratic here,
+        // so the returned (post-step) vol is already good to ~1e-15
+        double vol_tolerance = 1e-8;
+        double max_vol = 10.0;          // Upper end of the initial bracket (1000%)
+    };
+
+    template <simd::ISA Arch = simd::CurrentArch, simd::Accuracy Acc = simd::Accuracy::Accurate>
+    struct ImpliedVol {
+        using VM = simd::VectorMath<Arch, Acc>;
+        using BS = BlackScholes<Arch, Acc>;
+        using Reg = typename VM::Reg;
+        using Mask = typename VM::Mask;
+        static constexpr size_t Width = VM::Width;
+
+        /**
+         * @brief Solves one register of options. guess <= 0 (or NaN) lanes
+         * start from the closed form. Adds the register's iteration count
+         * (its slowest lane) to *iterations.
+         */
+        static FORCE_INLINE Reg solve(const Market& m, const Reg& strike, const Reg& expiry, const Reg& price,
+                                      const Reg& phi_in, const Reg& guess, const ImpliedVolConfig& cfg,
+                                      size_t* iterations = nullptr) {
+            const Reg zero = VM::broadcast(0.0);
+            const Reg t = expiry > 0.0 ? expiry : zero;
+            const Reg sqrt_t = VM::sqrt(t);
+            const Reg sdq = m.spot * VM::exp(-m.dividend * t);
+            const Reg kdf = strike * VM::exp(-m.rate * t);
+            const Reg x = VM::log(m.spot / strike) + (m.rate - m.dividend) * t;
+
+            // Solve the out-of-the-money side: subtract the forward intrinsic value
+            const Reg fwd = sdq - kdf;
+            const Mask itm = phi_in * fwd > 0.0;
+            const Reg phi = itm ? -phi_in : phi_in;
+            const Reg target = itm ? price - phi_in * fwd : price;
+            const Reg upper = phi > 0.0 ? sdq : kdf;
+            const Mask valid = (t > 0.0) && (target > 0.0) && (target < upper);
+
+            // Corrado-Miller on the call-equivalent price
+            const Reg call = phi > 0.0 ? target : target + fwd;
+            const Reg a = call - 0.5 * fwd;
+            const Reg disc = a * a - fwd * fwd * (1.0 / detail::Pi);
+            const Reg root = VM::sqrt(disc > 0.0 ? disc : zero);
+            const Reg cm = detail::Sqrt2Pi * (a + root) / ((sdq + kdf) * (valid ? sqrt_t : VM::broadcast(1.0)));
+
+            Reg lo = zero;
+            Reg hi = VM::broadcast(cfg.max_vol);
+            const Reg start = guess > 0.0 ? guess : cm;
+            Reg vol = (start > 0.0) && (start < hi) ? start : 0.5 * hi;
+            Mask active = valid;
+
+            int iter = 0;
+            for (; iter < cfg.max_iterations && VM::any(active); ++iter) {
+                const Reg sst = vol * sqrt_t;
+                const Reg d1 = x / sst + 0.5 * sst;
+                const Reg d2 = d1 - sst;
+                const Reg model = phi * (sdq * VM::norm_cdf(phi * d1) - kdf * VM::norm_cdf(phi * d2));
+                const Reg vega = sdq * sqrt_t * detail::InvSqrt2Pi * VM::exp(-0.5 * d1 * d1);
+                const Reg diff = model - target;
+
+                hi = active && diff > 0.0 ? vol : hi;
+                lo = active && diff <= 0.0 ? vol : lo;
+                // Newton on log(price): the out-of-the-money price spans many decades in vol
+                const Reg newton = vol - VM::log(model / target) * model / vega;
+                const Reg bisect = newton >= lo && newton <= hi ? newton : 0.5 * (lo + hi);
+                const Reg next = diff == 0.0 ? vol : bisect;
+                const Reg step = next - vol;
+                const Mask done = active && (diff == 0.0 || (step < cfg.vol_tolerance && step > -cfg.vol_tolerance));
+
+                vol = active ? next : vol;
+                active = active && !done;
+            }
+            if (iterations) *iterations += static_cast<size_t>(iter);
+            return valid && !active ? vol : VM::broadcast(std::numeric_limits<double>::quiet_NaN());
+        }
+
+        /**
+         * @brief vol_out[i] = implied vol of prices[i]; chain.vol, if set,
+         * is the warm start. Returns how many options got NaN.
+         */
+        static size_t solve(const Market& m, const OptionChain& chain, const double* prices, double* vol_out,
+                            const ImpliedVolConfig& cfg = {}, size_t* iterations = nullptr) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("ImpliedVol<") + simd::to_string(Arch) + ">::solve");
+            VM::blocks(chain.n, [&](size_t i, size_t count) __attribute__((always_inline)) {
+                const Reg guess = chain.vol ? VM::load(chain.vol + i, count) : VM::broadcast(0.0);
+                Reg phi;
+                BS::load_phi(chain.type + i, count, phi);
+                const Reg vol = solve(m, VM::load(chain.strike + i, count), VM::load(chain.expiry + i, count),
+                                      VM::load(prices + i, count), phi, guess, cfg, iterations);
+                VM::store(vol_out + i, vol, count);
+            });
+            size_t failed = 0;
+            for (size_t i = 0; i < chain.n; ++i) failed += vol_out[i] != vol_out[i];
+            return failed;
+        }
+    };
+
+} // namespace pricing
+} // namespace fwilliamsca
@@ -0,0 +1,169 @@
+/**
+ * @file monte_carlo.h
+ * @brief Correlated geometric Brownian motion paths on the SIMD tiers.
+ * * Paths are vectorized across lanes: a register holds 8 (AVX512_F) or 4
+ * (AVX2/AVX512_VL) paths that advance through time together. Path p draws
+ * its normals from Philox stream p of the engine's seed, so a path is a
+ * pure function of (seed, p) and any subset of paths can be regenerated,
+ * on any tier or thread count, without replaying the others.
+ *
+ * Model, per asset a and step of length dt:
+ *   log S_a += (mu_a - sigma_a^2 / 2) dt + sigma_a sqrt(dt) z_a,   z = L eps
+ * where eps are independent standard normals and L is a lower-triangular
+ * factor of the asset correlation matrix (L L^T = C); without L the assets
+ * are independent. Normal j = step * assets + asset of a path is element
+ * j of its stream (see simd/random.h).
+ *
+ * Output is time-major: out[(step * assets + asset) * paths + path], so
+ * each (step, asset) row is contiguous across paths for payoff kernels.
+ *
+ * Usage:
+ *   pricing::GbmPathEngine<> mc({{100.0, 0.03, 0.2}, {50.0, 0.03, 0.3}}, 1.0 / 252, seed, chol);
+ *   mc.simulate(pool, 0, paths, steps, out);   // out: steps * 2 * paths doubles
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../simd/random.h"
+#include "../concurrency/thread_pool.h"
+
+namespace fwilliamsca {
+namespace pricing {
+
+    struct GbmAsset {
+        double spot;
+        double drift;   // Annualized (r - q under the risk-neutral measure)
+        double vol;     // Annualized
+    };
+
+    template <simd::ISA Arch = simd::CurrentArch, simd::Accuracy Acc = simd::Accuracy::Fast>
+    class GbmPathEngine {
+    public:
+        using Rng = simd::Philox<Arch, Acc>;
+        using VM = typename Rng::VM;
+        using Reg = typename Rng::Reg;
+        using Bits = typename Rng::Bits;
+        static constexpr size_t Width = Rng::Width;
+
+        // Paths per parallel task (a multiple of every register width)
+        static constexpr size_t ChunkPaths = 1024;
+
+        /**
+         * @param factor Row-major assets x assets lower-triangular factor of
+         * the correlation matrix (upper triangle ignored); empty for
+         * independent assets.
+         */
+        GbmPathEngine(std::vector<GbmAsset> assets, double dt, uint64_t seed, std::vector<double> factor = {})
+            : assets_(std::move(assets)), seed_(seed), factor_(std::move(factor)) {
+            const size_t d = assets_.size();
+            if (!factor_.empty() && factor_.size() != d * d) {
+                throw std::invalid_argument("GbmPathEngine: factor must be assets x assets");
+            }
+            log_spot_.resize(d);
+            drift_dt_.resize(d);
+            vol_sqrt_dt_.resize(d);
+            for (size_t a = 0; a < d; ++a) {
+                log_spot_[a] = std::log(assets_[a].spot);
+                drift_dt_[a] = (assets_[a].drift - 0.5 * assets_[a].vol * assets_[a].vol) * dt;
+                vol_sqrt_dt_[a] = assets_[a].vol * std::sqrt(dt);
+            }
+        }
+
+        size_t assets() const { return assets_.size(); }
+        uint64_t seed() const { return seed_; }
+
+        /**
+         * @brief Paths [first_path, first_path + paths) over steps steps;
+         * out holds steps * assets() * paths doubles.
+         */
+        void simulate(uint64_t first_path, size_t paths, size_t steps, double* out) const {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("GbmPathEngine<") + simd::to_string(Arch) + ">::simulate");
+            run(first_path, paths, steps, out, paths);
+        }
+
+        /**
+         * @brief Same output as the serial overload, split into ChunkPaths
+         * column blocks across the pool.
+         */
+        void simulate(concurrency::ThreadPool& pool, uint64_t first_path, size_t paths, size_t steps,
+                      double* out) const {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("GbmPathEngine<") + simd::to_string(Arch) + ">::simulate");
+            const size_t chunks = (paths + ChunkPaths - 1) / ChunkPaths;
+            pool.parallel_for(chunks, [&](size_t c) {
+                const size_t begin = c * ChunkPaths;
+                const size_t count = paths - begin < ChunkPaths ? paths - begin : ChunkPaths;
+                run(first_path + begin, count, steps, out + begin, paths);
+            });
+        }
+
+    private:
+        // Paths [first, first + paths) into columns of rows with stride row_stride
+        void run(uint64_t first, size_t paths, size_t steps, double* out, size_t row_stride) const {
+            const size_t d = assets_.size();
+            if (d == 0 || steps == 0) return;
+
+            // eps and log S per asset, one register each; reused across calls on this thread
+            thread_local std::vector<double> scratch;
+            scratch.resize(2 * d * Width);
+            double* eps_mem = scratch.data();
+            double* log_s_mem = scratch.data() + d * Width;
+
+            const uint64_t seed = seed_;
+            const double* factor = factor_.empty() ? nullptr : factor_.data();
+            VM::blocks(paths, [&](size_t i, size_t count) __attribute__((always_inline)) {
+                const Bits stream = Rng::consecutive(first + i);
+                for (size_t a = 0; a < d; ++a) store(log_s_mem, a, VM::broadcast(log_spot_[a]));
+
+                Reg pending = VM::broadcast(0.0);
+                uint64_t j = 0;
+                for (size_t s = 0; s < steps; ++s) {
+                    for (size_t a = 0; a < d; ++a, ++j) {
+                        // Element j of each path's stream: block j / 2, cos branch first
+                        Reg e;
+                        if (j % 2 == 0) Rng::normal_pair(seed, Bits{} + j / 2, stream, e, pending);
+                        else e = pending;
+
+                        Reg z = e;
+                        if (factor) {
+                            store(eps_mem, a, e);
+                            const double* row = factor + a * d;
+                            z = row[a] * e;
+                            for (size_t b = 0; b < a; ++b) z += row[b] * load(eps_mem, b);
+                        }
+                        const Reg log_s = load(log_s_mem, a) + drift_dt_[a] + vol_sqrt_dt_[a] * z;
+                        store(log_s_mem, a, log_s);
+                        VM::store(out + (s * d + a) * row_stride + i, VM::exp(log_s), count);
+                    }
+                }
+            });
+        }
+
+        static FORCE_INLINE Reg load(const double* mem, size_t k) {
+            Reg r;
+            std::memcpy(&r, mem + k * Width, sizeof(Reg));
+            return r;
+        }
+
+        static FORCE_INLINE void store(double* mem, size_t k, const Reg& r) {
+            std::memcpy(mem + k * Width, &r, sizeof(Reg));
+        }
+
+        std::vector<GbmAsset> assets_;
+        uint64_t seed_;
+        std::vector<double> factor_;
+        std::vector<double> log_spot_;
+        std::vector<double> drift_dt_;
+        std::vector<double> vol_sqrt_dt_;
+    };
+
+} // namespace pricing
+} // namespace fwilliamsca
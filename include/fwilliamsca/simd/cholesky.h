@@ -0,0 +1,410 @@
+/**
+ * @file cholesky.h
+ * @brief Cache-blocked Cholesky factorization and batched lower-triangular
+ * multiply (double and float) on the MathKernel ISA tiers.
+ * * Turning a covariance matrix into correlated shocks needs A = L L^T and
+ * z = L x per draw. Both are built from one register-blocked kernel: a
+ * tile of 4 x C dot products (C = 4 with 32 vector registers, 2 on AVX2)
+ * whose FMA chains run along contiguous rows, so every loaded register
+ * feeds several accumulators instead of MathKernel::dot_product's one.
+ *
+ * Storage is row-major with the factor in the lower triangle; the upper
+ * triangle is neither read nor written, as in LAPACK's potrf.
+ * - factor() is left-looking by blocks of 64 columns: each block column
+ *   is first updated with every finished column (the O(n^3 / 6) bulk, in
+ *   2 KB k-slices so the block's rows stay in L2). Its diagonal block is
+ *   then factored with short dots, and the rows below are solved against
+ *   it four at a time along contiguous row segments.
+ * - lower_multiply() computes z_b = L x_b for a batch of contiguous draws,
+ *   blocking the batch so a slice of it stays in L2 while L streams once
+ *   per batch block.
+ *
+ * float runs twice the lanes and accumulates in float: enough for shock
+ * generation, not for ill-conditioned matrices. Summation order depends
+ * only on n and the tier, so results are reproducible run to run.
+ *
+ * Usage:
+ *   if (!simd::Cholesky<>::factor(cov, n)) { ... }   // not positive definite
+ *   simd::Cholesky<>::lower_multiply(cov, n, eps, z, draws);
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "vector_math.h"
+
+namespace fwilliamsca {
+namespace simd {
+
+    /**
+     * @brief Scalar reference factorization (unblocked Cholesky-Crout).
+     */
+    template <class T>
+    inline bool cholesky_reference(T* a, size_t n, size_t lda) {
+        for (size_t j = 0; j < n; ++j) {
+            T* rj = a + j * lda;
+            T d = rj[j];
+            for (size_t k = 0; k < j; ++k) d -= rj[k] * rj[k];
+            if (!(d > 0)) return false;
+            rj[j] = std::sqrt(d);
+            for (size_t i = j + 1; i < n; ++i) {
+                T* ri = a + i * lda;
+                T s = ri[j];
+                for (size_t k = 0; k < j; ++k) s -= ri[k] * rj[k];
+                ri[j] = s / rj[j];
+            }
+        }
+        return true;
+    }
+
+    template <class T>
+    inline void lower_multiply_reference(const T* l, size_t n, const T* x, T* z, size_t batch) {
+        for (size_t b = 0; b < batch; ++b) {
+            for (size_t i = 0; i < n; ++i) {
+                T s = 0;
+                for (size_t k = 0; k <= i; ++k) s += l[i * n + k] * x[b * n + k];
+                z[b * n + i] = s;
+            }
+        }
+    }
+
+    namespace detail {
+
+        // T in a register of the tier's width (T itself on Scalar)
+        template <class T, ISA Arch>
+        struct TileReg {
+            typedef T type __attribute__((vector_size(sizeof(typename VecTraits<Arch>::Reg))));
+        };
+
+        template <class T>
+        struct TileReg<T, ISA::Scalar> {
+            typedef T type;
+        };
+
+        constexpr size_t CholeskyBlockCols = 64;
+        constexpr size_t CholeskySliceBytes = 2048;     // k-slice per row: 64 rows x 2 KB fit L2
+        constexpr size_t CholeskyBatchBlock = 64;
+
+        // Pairwise halving: log2(W) adds instead of a W-long chain
+        template <class T, class V>
+        FORCE_INLINE T lane_sum(const V& v) {
+            if constexpr (std::is_same_v<V, T>) {
+                return v;
+            } else if constexpr (sizeof(V) == 2 * sizeof(T)) {
+                return v[0] + v[1];
+            } else {
+                typedef T Half __attribute__((vector_size(sizeof(V) / 2)));
+                Half lo, hi;
+                std::memcpy(&lo, &v, sizeof(Half));
+                std::memcpy(&hi, reinterpret_cast<const char*>(&v) + sizeof(Half), sizeof(Half));
+                return lane_sum<T>(lo + hi);
+            }
+        }
+
+        /**
+         * @brief out[r][c] = sum_k a[r * lda + k] * b[c * ldb + k] for k < len.
+         * Tiles under four accumulators run four chains per product to hide
+         * FMA latency.
+         */
+        template <class V, class T, int R, int C>
+        FORCE_INLINE void dot_tile(const T* a, size_t lda, const T* b, size_t ldb, size_t len, T (&out)[R][C]) {
+            constexpr size_t W = sizeof(V) / sizeof(T);
+            constexpr int Chains = R * C >= 4 ? 1 : 4;
+            V acc[Chains][R][C] = {};
+            size_t k = 0;
+            // Fully unrolled so the accumulators live in registers (-O2 keeps short loops rolled)
+            for (; k + Chains * W <= len; k += Chains * W) {
+#pragma GCC unroll 4
+                for (int h = 0; h < Chains; ++h) {
+                    V bv[C];
+#pragma GCC unroll 4
+                    for (int c = 0; c < C; ++c) std::memcpy(&bv[c], b + c * ldb + k + h * W, sizeof(V));
+#pragma GCC unroll 4
+                    for (int r = 0; r < R; ++r) {
+                        V av;
+                        std::memcpy(&av, a + r * lda + k + h * W, sizeof(V));
+#pragma GCC unroll 4
+                        for (int c = 0; c < C; ++c) acc[h][r][c] += av * bv[c];
+                    }
+                }
+            }
+            for (; k + W <= len; k += W) {
+#pragma GCC unroll 4
+                for (int r = 0; r < R; ++r) {
+                    V av;
+                    std::memcpy(&av, a + r * lda + k, sizeof(V));
+#pragma GCC unroll 4
+                    for (int c = 0; c < C; ++c) {
+                        V bv;
+                        std::memcpy(&bv, b + c * ldb + k, sizeof(V));
+                        acc[0][r][c] += av * bv;
+                    }
+                }
+            }
+#pragma GCC unroll 4
+            for (int r = 0; r < R; ++r) {
+#pragma GCC unroll 4
+                for (int c = 0; c < C; ++c) {
+                    V v = acc[0][r][c];
+                    for (int h = 1; h < Chains; ++h) v += acc[h][r][c];
+                    T s = lane_sum<T>(v);
+                    for (size_t kk = k; kk < len; ++kk) s += a[r * lda + kk] * b[c * ldb + kk];
+                    out[r][c] = s;
+                }
+            }
+        }
+
+        template <class V, class T>
+        FORCE_INLINE T dot(const T* a, const T* b, size_t len) {
+            T s[1][1];
+            dot_tile<V, T, 1, 1>(a, 0, b, 0, len, s);
+            return s[0][0];
+        }
+
+        /**
+         * @brief x L_b^T = row for R rows of one block column, in place
+         * (lt: the diagonal block transposed, zero on and above its diagonal).
+         * R rows run interleaved to overlap their dependency chains.
+         */
+        template <class V, class T, int R>
+        FORCE_INLINE void solve_rows(T* rows, size_t lda, size_t w, const T (&lt)[CholeskyBlockCols][CholeskyBlockCols],
+                                     const T (&inv)[CholeskyBlockCols]) {
+            constexpr size_t W = sizeof(V) / sizeof(T);
+            const size_t padded = (w + W - 1) / W * W;
+            alignas(64) T rest[R][CholeskyBlockCols];
+            T x[R][CholeskyBlockCols];
+            for (int r = 0; r < R; ++r) {
+                std::memcpy(rest[r], rows + r * lda, w * sizeof(T));
+                for (size_t j = w; j < padded; ++j) rest[r][j] = 0;
+            }
+            for (size_t j = 0; j < w; ++j) {
+#pragma GCC unroll 4
+                for (int r = 0; r < R; ++r) x[r][j] = rest[r][j] * inv[j];
+                // Whole registers from the one holding j: lt is zero up to j, so earlier lanes keep their value
+                for (size_t c = j / W * W; c < padded; c += W) {
+                    V l;
+                    std::memcpy(&l, lt[j] + c, sizeof(V));
+#pragma GCC unroll 4
+                    for (int r = 0; r < R; ++r) {
+                        V v;
+                        std::memcpy(&v, rest[r] + c, sizeof(V));
+                        v -= x[r][j] * l;
+                        std::memcpy(rest[r] + c, &v, sizeof(V));
+                    }
+                }
+            }
+            for (int r = 0; r < R; ++r) std::memcpy(rows + r * lda, x[r], w * sizeof(T));
+        }
+
+        template <class V, class T, int C>
+        FORCE_INLINE bool cholesky_blocked(T* a, size_t n, size_t lda) {
+            constexpr int R = 4;
+            constexpr size_t Slice = CholeskySliceBytes / sizeof(T);
+            for (size_t j0 = 0; j0 < n; j0 += CholeskyBlockCols) {
+                const size_t j1 = std::min(j0 + CholeskyBlockCols, n);
+
+                // A[i][j0:j1] -= L[i][0:j0] . L[j][0:j0] for every row i >= j0
+                for (size_t k0 = 0; k0 < j0; k0 += Slice) {
+                    const size_t len = std::min(Slice, j0 - k0);
+                    size_t i = j0;
+                    for (; i + R <= n; i += R) {
+                        T* ri = a + i * lda;
+                        size_t j = j0;
+                        // Whole tiles on or below the diagonal
+                        for (; j + C <= j1 && j + C - 1 <= i; j += C) {
+                            T s[R][C];
+                            dot_tile<V, T, R, C>(ri + k0, lda, a + j * lda + k0, lda, len, s);
+                            for (int r = 0; r < R; ++r) {
+                                for (int c = 0; c < C; ++c) ri[r * lda + j + c] -= s[r][c];
+                            }
+                        }
+                        for (; j < j1 && j <= i + R - 1; ++j) {
+                            for (int r = 0; r < R; ++r) {
+                                if (j <= i + r) ri[r * lda + j] -= dot<V>(ri + r * lda + k0, a + j * lda + k0, len);
+                            }
+                        }
+                    }
+                    for (; i < n; ++i) {
+                        T* ri = a + i * lda;
+                        for (size_t j = j0; j < j1 && j <= i; ++j) ri[j] -= dot<V>(ri + k0, a + j * lda + k0, len);
+                    }
+                }
+
+                // Factor the diagonal block
+                for (size_t i = j0; i < j1; ++i) {
+                    T* ri = a + i * lda;
+                    for (size_t j = j0; j <= i; ++j) {
+                        const T* rj = a + j * lda;
+                        const T v = ri[j] - dot<V>(ri + j0, rj + j0, j - j0);
+                        if (j == i) {
+                            if (!(v > 0)) return false;
+                            ri[i] = std::sqrt(v);
+                        } else {
+                            ri[j] = v / rj[j];
+                        }
+                    }
+                }
+                if (j1 == n) break;
+
+                // Solve the rows below against it: transposed, zero-padded, so elimination runs along rows
+                const size_t w = j1 - j0;
+                alignas(64) T lt[CholeskyBlockCols][CholeskyBlockCols] = {};
+                T inv[CholeskyBlockCols];
+                for (size_t j = 0; j < w; ++j) {
+                    inv[j] = 1 / a[(j0 + j) * lda + j0 + j];
+                    for (size_t jj = j + 1; jj < w; ++jj) lt[j][jj] = a[(j0 + jj) * lda + j0 + j];
+                }
+                size_t i = j1;
+                for (; i + R <= n; i += R) solve_rows<V, T, R>(a + i * lda + j0, lda, w, lt, inv);
+                for (; i < n; ++i) solve_rows<V, T, 1>(a + i * lda + j0, lda, w, lt, inv);
+            }
+            return true;
+        }
+
+        template <class V, class T, int C>
+        FORCE_INLINE void lower_multiply_blocked(const T* l, size_t n, const T* x, T* z, size_t batch) {
+            constexpr int R = 4;
+            constexpr size_t Slice = CholeskySliceBytes / sizeof(T);
+            for (size_t b0 = 0; b0 < batch; b0 += CholeskyBatchBlock) {
+                const size_t b1 = std::min(b0 + CholeskyBatchBlock, batch);
+                std::memset(z + b0 * n, 0, (b1 - b0) * n * sizeof(T));
+
+                for (size_t k0 = 0; k0 < n; k0 += Slice) {
+                    const size_t k1 = std::min(k0 + Slice, n);
+
+                    // Rows inside the slice's triangle: row i uses k in [k0, i]
+                    size_t i = k0;
+                    for (; i + 1 < k1; ++i) {
+                        const T* li = l + i * n + k0;
+                        const size_t len = i + 1 - k0;
+                        size_t b = b0;
+                        for (; b + C <= b1; b += C) {
+                            T s[1][C];
+                            dot_tile<V, T, 1, C>(li, n, x + b * n + k0, n, len, s);
+                            for (int c = 0; c < C; ++c) z[(b + c) * n + i] += s[0][c];
+                        }
+                        for (; b < b1; ++b) z[b * n + i] += dot<V>(li, x + b * n + k0, len);
+                    }
+
+                    // Rows at or past the slice's end use all of it
+                    const size_t len = k1 - k0;
+                    for (; i + R <= n; i += R) {
+                        const T* li = l + i * n + k0;
+                        size_t b = b0;
+                        for (; b + C <= b1; b += C) {
+                            T s[R][C];
+                            dot_tile<V, T, R, C>(li, n, x + b * n + k0, n, len, s);
+                            for (int c = 0; c < C; ++c) {
+                                for (int r = 0; r < R; ++r) z[(b + c) * n + i + r] += s[r][c];
+                            }
+                        }
+                        for (; b < b1; ++b) {
+                            T s[R][1];
+                            dot_tile<V, T, R, 1>(li, n, x + b * n + k0, n, len, s);
+                            for (int r = 0; r < R; ++r) z[b * n + i + r] += s[r][0];
+                        }
+                    }
+                    for (; i < n; ++i) {
+                        for (size_t b = b0; b < b1; ++b) z[b * n + i] += dot<V>(l + i * n + k0, x + b * n + k0, len);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief One factor/multiply loop per tier with the tier's target
+         * attribute (see VectorLoop).
+         */
+        template <ISA Arch>
+        struct CholeskyLoop {
+            template <class T>
+            static __attribute__((flatten)) inline bool factor(T* a, size_t n, size_t lda) {
+                return cholesky_blocked<T, T, 2>(a, n, lda);
+            }
+            template <class T>
+            static __attribute__((flatten)) inline void lower_multiply(const T* l, size_t n, const T* x, T* z,
+                                                                       size_t batch) {
+                lower_multiply_blocked<T, T, 2>(l, n, x, z, batch);
+            }
+        };
+
+        template <>
+        struct CholeskyLoop<ISA::AVX512_F> {
+            template <class T>
+            static KERNEL_AVX512 __attribute__((flatten)) bool factor(T* a, size_t n, size_t lda) {
+                return cholesky_blocked<typename TileReg<T, ISA::AVX512_F>::type, T, 4>(a, n, lda);
+            }
+            template <class T>
+            static KERNEL_AVX512 __attribute__((flatten)) void lower_multiply(const T* l, size_t n, const T* x, T* z,
+                                                                               size_t batch) {
+                lower_multiply_blocked<typename TileReg<T, ISA::AVX512_F>::type, T, 4>(l, n, x, z, batch);
+            }
+        };
+
+        template <>
+        struct CholeskyLoop<ISA::AVX512_VL> {
+            template <class T>
+            static KERNEL_AVX512_VL __attribute__((flatten)) bool factor(T* a, size_t n, size_t lda) {
+                return cholesky_blocked<typename TileReg<T, ISA::AVX512_VL>::type, T, 4>(a, n, lda);
+            }
+            template <class T>
+            static KERNEL_AVX512_VL __attribute__((flatten)) void lower_multiply(const T* l, size_t n, const T* x,
+                                                                                  T* z, size_t batch) {
+                lower_multiply_blocked<typename TileReg<T, ISA::AVX512_VL>::type, T, 4>(l, n, x, z, batch);
+            }
+        };
+
+        template <>
+        struct CholeskyLoop<ISA::AVX2> {
+            template <class T>
+            static KERNEL_AVX2 __attribute__((flatten)) bool factor(T* a, size_t n, size_t lda) {
+                return cholesky_blocked<typename TileReg<T, ISA::AVX2>::type, T, 2>(a, n, lda);
+            }
+            template <class T>
+            static KERNEL_AVX2 __attribute__((flatten)) void lower_multiply(const T* l, size_t n, const T* x, T* z,
+                                                                             size_t batch) {
+                lower_multiply_blocked<typename TileReg<T, ISA::AVX2>::type, T, 2>(l, n, x, z, batch);
+            }
+        };
+
+    } // namespace detail
+
+    template <ISA Arch = CurrentArch>
+    struct Cholesky {
+        /**
+         * @brief In place A = L L^T on the lower triangle of the row-major
+         * n x n matrix a (row stride lda). Returns false, with a partially
+         * overwritten, if A is not positive definite.
+         */
+        template <class T>
+        static bool factor(T* a, size_t n, size_t lda) {
+            static_assert(std::is_same_v<T, double> || std::is_same_v<T, float>, "Cholesky: double or float");
+            FWILLIAMSCA_TRACE_SCOPE(std::string("Cholesky<") + to_string(Arch) + ">::factor");
+            return detail::CholeskyLoop<Arch>::factor(a, n, lda);
+        }
+
+        template <class T>
+        static bool factor(T* a, size_t n) {
+            return factor(a, n, n);
+        }
+
+        /**
+         * @brief z_b = L x_b for b < batch, draw b at x + b * n (z likewise,
+         * not aliasing x); l is n x n, upper triangle ignored.
+         */
+        template <class T>
+        static void lower_multiply(const T* l, size_t n, const T* x, T* z, size_t batch) {
+            static_assert(std::is_same_v<T, double> || std::is_same_v<T, float>, "Cholesky: double or float");
+            FWILLIAMSCA_TRACE_SCOPE(std::string("Cholesky<") + to_string(Arch) + ">::lower_multiply");
+            detail::CholeskyLoop<Arch>::lower_multiply(l, n, x, z, batch);
+        }
+    };
+
+} // namespace simd
+} // namespace fwilliamsca
@@ -6,6 +6,16 @@
  * * This module provides compile-time abstraction over hardware intrinsics
  * to ensure maximum throughput for financial time-series analysis.
  * We strictly avoid virtual functions to prevent vtable lookup overhead.
+ *
+ * Every specialization is compiled regardless of -m flags: tiers the
+ * compiler targets are force-inlined, the others carry a per-function
+ * target attribute so one binary can hold (and benchmark) all of them.
+ * Call a non-native tier only after cpu_supports() confirms it.
+ *
+ * AVX512_VL runs AVX-512 instructions on 256-bit registers: masked tails
+ * and 32 vector registers without the 512-bit frequency license that
+ * AVX512_F triggers on Skylake-SP class cores. Pick per host between the
+ * wider tier's throughput and keeping the core's clock up (see --freq).
  */
 
 #pragma once
@@ -16,10 +26,29 @@
 #include <array>
 #include <cmath>
 
+#include "../trace/trace.h"
+
 // Configuration Macros
 #define FORCE_INLINE __attribute__((always_inline)) inline
 #define CACHE_LINE 64
 
+// Kernel qualifiers per tier: native tiers inline, others get their own target
+#if defined(__AVX512F__)
+#define KERNEL_AVX512 FORCE_INLINE
+#else
+#define KERNEL_AVX512 __attribute__((target("avx512f,fma"))) inline
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+#define KERNEL_AVX512_VL FORCE_INLINE
+#else
+#define KERNEL_AVX512_VL __attribute__((target("avx512f,avx512vl,fma"))) inline
+#endif
+#if defined(__AVX2__)
+#define KERNEL_AVX2 FORCE_INLINE
+#else
+#define KERNEL_AVX2 __attribute__((target("avx2,fma"))) inline
+#endif
+
 namespace fwilliamsca {
 namespace simd {
 
@@ -32,7 +61,8 @@ namespace simd {
         SSE4_2,
         AVX2,
         AVX512_F,
-        AVX512_BW
+        AVX512_BW,
+        AVX512_VL       // AVX-512 instructions on 256-bit registers
     };
 
     // Compile-time constant for current architecture
@@ -48,6 +78,35 @@ namespace simd {
     constexpr ISA CurrentArch = ISA::Scalar;
 #endif
 
+    inline const char* to_string(ISA isa) {
+        switch (isa) {
+            case ISA::Scalar:    return "Scalar";
+            case ISA::SSE4_2:    return "SSE4_2";
+            case ISA::AVX2:      return "AVX2";
+            case ISA::AVX512_F:  return "AVX512_F";
+            case ISA::AVX512_BW: return "AVX512_BW";
+            case ISA::AVX512_VL: return "AVX512_VL";
+        }
+        return "?";
+    }
+
+    /**
+     * @brief Runtime check (CPUID + OS register-state support) that the host
+     * can execute the given tier. The AVX2 tier assumes FMA (Haswell+).
+     */
+    inline bool cpu_supports(ISA isa) {
+        __builtin_cpu_init();
+        switch (isa) {
+            case ISA::Scalar:    return true;
+            case ISA::SSE4_2:    return __builtin_cpu_supports("sse4.2");
+            case ISA::AVX2:      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            case ISA::AVX512_F:  return __builtin_cpu_supports("avx512f");
+            case ISA::AVX512_BW: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+            case ISA::AVX512_VL: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl");
+        }
+        return false;
+    }
+
     /**
      * @brief Double Precision Math Kernel (AVX-512 Specialized)
      * Handles 8 double-precision floating point numbers per cycle.
@@ -56,8 +115,16 @@ namespace simd {
     struct MathKernel {
         // Fallback for non-SIMD architectures
         static FORCE_INLINE void add(const double* a, const double* b, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE("MathKernel<Scalar>::add");
             for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
         }
+
+        static FORCE_INLINE double dot_product(const double* a, const double* b, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE("MathKernel<Scalar>::dot_product");
+            double result = 0.0;
+            for (size_t i = 0; i < n; ++i) result += a[i] * b[i];
+            return result;
+        }
     };
 
     /**
@@ -67,7 +134,8 @@ namespace simd {
     template <>
     struct MathKernel<ISA::AVX512_F> {
         
-        static FORCE_INLINE void add(const double* a, const double* b, double* out, size_t n) {
+        static KERNEL_AVX512 void add(const double* a, const double* b, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE("MathKernel<AVX512_F>::add");
             size_t i = 0;
             // Unroll loop 4 times (32 doubles per iteration)
             // This maximizes instruction-level parallelism (ILP).
@@ -93,6 +161,13 @@ namespace simd {
                 _mm512_storeu_pd(out + i + 24, r3);
             }
             
+            // Up to 31 elements remain: full registers first
+            for (; i + 7 < n; i += 8) {
+                __m512d a0 = _mm512_loadu_pd(a + i);
+                __m512d b0 = _mm512_loadu_pd(b + i);
+                _mm512_storeu_pd(out + i, _mm512_add_pd(a0, b0));
+            }
+
             // Handle cleanup with AVX mask
             if (i < n) {
                 uint8_t remaining = n - i;
@@ -108,7 +183,8 @@ namespace simd {
          * @brief Dot Product Calculation using FMA (Fused Multiply-Add)
          * Critical path for correlation matrices in HFT strategies.
          */
-        static FORCE_INLINE double dot_product(const double* a, const double* b, size_t n) {
+        static KERNEL_AVX512 double dot_product(const double* a, const double* b, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE("MathKernel<AVX512_F>::dot_product");
             __m512d sum = _mm512_setzero_pd();
             size_t i = 0;
             
@@ -119,8 +195,12 @@ namespace simd {
                 sum = _mm512_fmadd_pd(va, vb, sum); 
             }
 
-            // Reduce horizontal sum
-            double result = _mm512_reduce_add_pd(sum);
+            // Reduce horizontal sum: halves, quarters, pair. Through memory because
+            // GCC 12's 512-bit shuffle/extract intrinsics trip -Wmaybe-uninitialized
+            alignas(64) double lanes[8];
+            _mm512_store_pd(lanes, sum);
+            double result = ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) +
+                            ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
 
             // Scalar cleanup
             for (; i < n; ++i) {
@@ -130,13 +210,75 @@ namespace simd {
         }
     };
 
+    /**
+     * @brief Specialization for AVX-512VL on 256-bit registers
+     * Same instruction set as AVX512_F, but ymm-only code stays in the
+     * lighter frequency license; the extra registers carry four
+     * independent FMA chains and masks replace the scalar tails.
+     */
+    template <>
+    struct MathKernel<ISA::AVX512_VL> {
+        static KERNEL_AVX512_VL void add(const double* a, const double* b, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE("MathKernel<AVX512_VL>::add");
+            size_t i = 0;
+            for (; i + 15 < n; i += 16) {
+                __m256d r0 = _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+                __m256d r1 = _mm256_add_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4));
+                __m256d r2 = _mm256_add_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8));
+                __m256d r3 = _mm256_add_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12));
+                _mm256_storeu_pd(out + i, r0);
+                _mm256_storeu_pd(out + i + 4, r1);
+                _mm256_storeu_pd(out + i + 8, r2);
+                _mm256_storeu_pd(out + i + 12, r3);
+            }
+            for (; i + 3 < n; i += 4) {
+                _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+            }
+
+            // Masked tail (AVX-512VL encodings of the 256-bit loads/stores)
+            if (i < n) {
+                const __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+                __m256d a_rem = _mm256_maskz_loadu_pd(mask, a + i);
+                __m256d b_rem = _mm256_maskz_loadu_pd(mask, b + i);
+                _mm256_mask_storeu_pd(out + i, mask, _mm256_add_pd(a_rem, b_rem));
+            }
+        }
+
+        static KERNEL_AVX512_VL double dot_product(const double* a, const double* b, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE("MathKernel<AVX512_VL>::dot_product");
+            __m256d s0 = _mm256_setzero_pd();
+            __m256d s1 = _mm256_setzero_pd();
+            __m256d s2 = _mm256_setzero_pd();
+            __m256d s3 = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 15 < n; i += 16) {
+                s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+                s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+                s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), s2);
+                s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), s3);
+            }
+            for (; i + 3 < n; i += 4) {
+                s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+            }
+            if (i < n) {
+                const __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+                s1 = _mm256_fmadd_pd(_mm256_maskz_loadu_pd(mask, a + i), _mm256_maskz_loadu_pd(mask, b + i), s1);
+            }
+
+            __m256d sum = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
+            __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+            return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+        }
+    };
+
     /**
      * @brief Specialization for AVX2 (Legacy Support)
      * Fallback for older execution venues.
      */
     template <>
     struct MathKernel<ISA::AVX2> {
-        static FORCE_INLINE void add(const double* a, const double* b, double* out, size_t n) {
+        static KERNEL_AVX2 void add(const double* a, const double* b, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE("MathKernel<AVX2>::add");
             size_t i = 0;
             for (; i + 3 < n; i += 4) {
                 __m256d a0 = _mm256_loadu_pd(a + i);
@@ -145,6 +287,30 @@ namespace simd {
             }
             for (; i < n; ++i) out[i] = a[i] + b[i];
         }
+
+        static KERNEL_AVX2 double dot_product(const double* a, const double* b, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE("MathKernel<AVX2>::dot_product");
+            __m256d sum = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 3 < n; i += 4) {
+                __m256d va = _mm256_loadu_pd(a + i);
+                __m256d vb = _mm256_loadu_pd(b + i);
+#if defined(__FMA__) || !defined(__AVX2__)   // Target attribute includes FMA
+                sum = _mm256_fmadd_pd(va, vb, sum);
+#else
+                sum = _mm256_add_pd(_mm256_mul_pd(va, vb), sum);
+#endif
+            }
+
+            // Reduce horizontal sum (128-bit halves, then the pair)
+            __m128d lo = _mm256_castpd256_pd128(sum);
+            __m128d hi = _mm256_extractf128_pd(sum, 1);
+            lo = _mm_add_pd(lo, hi);
+            double result = _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+
+            for (; i < n; ++i) result += a[i] * b[i];
+            return result;
+        }
     };
 
 } // namespace simd
@@ -0,0 +1,121 @@
+/**
+ * @file parallel.h
+ * @brief Multi-threaded front-end for MathKernel on large arrays.
+ * * A single core cannot saturate the memory channels of a socket, so bulk
+ * (end-of-day, risk recomputation) workloads split arrays across a
+ * persistent ThreadPool and run the ISA kernel on each chunk.
+ * - Chunk boundaries are aligned to cache lines of the written array so
+ *   that no two threads ever store into the same line.
+ * - The chunk layout depends only on n and the array alignment (never on
+ *   the thread count), and partial reductions are summed in chunk order,
+ *   so results are bitwise reproducible across runs and pool sizes.
+ * - Below SerialThreshold elements the serial kernel is called directly.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "intrinsics.h"
+#include "../concurrency/thread_pool.h"
+
+namespace fwilliamsca {
+namespace simd {
+
+    template <ISA Arch = CurrentArch>
+    struct ParallelMathKernel {
+        using Kernel = MathKernel<Arch>;
+
+        // Below this size thread hand-off costs more than it saves (~2 MB per operand)
+        static constexpr size_t SerialThreshold = size_t(1) << 18;
+
+        // Minimum chunk length; keeps per-chunk overhead negligible
+        static constexpr size_t MinChunkElems = size_t(1) << 16;
+
+        // Upper bound on chunks per call (bounds the stack-resident partials)
+        static constexpr size_t MaxChunks = 256;
+
+        static constexpr size_t ElemsPerLine = CACHE_LINE / sizeof(double);
+
+        static void add(concurrency::ThreadPool& pool,
+                        const double* a, const double* b, double* out, size_t n) {
+            if (n < SerialThreshold || pool.size() == 1) {
+                Kernel::add(a, b, out, n);
+                return;
+            }
+            const Layout layout = make_layout(out, n);
+            pool.parallel_for(layout.num_chunks, [&](size_t c) {
+                const size_t begin = layout.begin(c);
+                const size_t end = layout.begin(c + 1);
+                Kernel::add(a + begin, b + begin, out + begin, end - begin);
+            });
+        }
+
+        /**
+         * @brief Dot product with a deterministic reduction order.
+         * * Note: for n >= SerialThreshold the summation order differs from
+         * the serial kernel, so the result may differ from
+         * MathKernel::dot_product in the last bits (but never between runs).
+         */
+        static double dot_product(concurrency::ThreadPool& pool,
+                                  const double* a, const double* b, size_t n) {
+            if (n < SerialThreshold || pool.size() == 1) {
+                return Kernel::dot_product(a, b, n);
+            }
+            const Layout layout = make_layout(a, n);
+
+            // One cache line per partial to avoid false sharing between workers
+            struct alignas(CACHE_LINE) Partial { double value; };
+            Partial partials[MaxChunks];
+
+            pool.parallel_for(layout.num_chunks, [&](size_t c) {
+                const size_t begin = layout.begin(c);
+                const size_t end = layout.begin(c + 1);
+                partials[c].value = Kernel::dot_product(a + begin, b + begin, end - begin);
+            });
+
+            // Fixed-order combine
+            double result = 0.0;
+            for (size_t c = 0; c < layout.num_chunks; ++c) {
+                result += partials[c].value;
+            }
+            return result;
+        }
+
+    private:
+        struct Layout {
+            size_t n;
+            size_t head;        // Elements before the first cache-line boundary
+            size_t chunk;       // Chunk length (multiple of ElemsPerLine)
+            size_t num_chunks;
+
+            // Chunk c covers [begin(c), begin(c + 1))
+            size_t begin(size_t c) const {
+                if (c == 0) return 0;
+                const size_t pos = head + c * chunk;
+                return pos < n ? pos : n;
+            }
+        };
+
+        static Layout make_layout(const double* anchor, size_t n) {
+            const uintptr_t misalign = reinterpret_cast<uintptr_t>(anchor) & (CACHE_LINE - 1);
+            size_t head = misalign ? (CACHE_LINE - misalign) / sizeof(double) : 0;
+            if (misalign % sizeof(double) != 0) {
+                head = 0; // Not element-aligned: no boundary can be line-aligned
+            }
+
+            size_t num_chunks = (n + MinChunkElems - 1) / MinChunkElems;
+            if (num_chunks > MaxChunks) num_chunks = MaxChunks;
+
+            size_t chunk = (n - head + num_chunks - 1) / num_chunks;
+            chunk = (chunk + ElemsPerLine - 1) & ~(ElemsPerLine - 1);
+
+            // Rounding up may leave trailing chunks empty; drop them
+            num_chunks = (n - head + chunk - 1) / chunk;
+            return Layout{n, head, chunk, num_chunks};
+        }
+    };
+
+} // namespace simd
+} // namespace fwilliamsca
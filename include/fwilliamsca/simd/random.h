@@ -0,0 +1,280 @@
+/**
+ * @file random.h
+ * @brief Counter-based Philox4x32-10 generator with vectorized uniforms and
+ * Box-Muller normals for every MathKernel tier.
+ * * std::mt19937 carries 2.5 KB of serial state and yields one 32-bit word
+ * per call, so Monte Carlo loops spend most of their time in it. Philox
+ * (Salmon et al., SC'11; the cuRAND/numpy/Random123 generator) is a pure
+ * function of (counter, key): ten multiply-xor rounds turn a 128-bit
+ * counter into 128 random bits. Every lane of a register runs its own
+ * counter, so a zmm produces 8 blocks per step, and any block of any
+ * stream is reachable in O(1): no jump-ahead, no shared state.
+ *
+ * Layout (identical on every tier, so results do not depend on the ISA):
+ * - key = seed; counter = (block index, stream id), 64 bits each.
+ * - Block k of a stream yields elements 2k and 2k+1: uniforms from its two
+ *   64-bit halves (top 52 bits each, [0, 1)), normals from Box-Muller on
+ *   that uniform pair (cos branch first).
+ *
+ * Normals use the Fast VectorMath tier by default (~1e-13 relative),
+ * far below Monte Carlo noise; Accuracy::Accurate is available.
+ *
+ * Usage:
+ *   simd::Philox<> rng(seed, stream);     // e.g. stream = thread or path id
+ *   rng.normal(z, n);                     // next n normals of this stream
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "vector_math.h"
+
+namespace fwilliamsca {
+namespace simd {
+
+    namespace detail {
+
+        constexpr uint64_t PhiloxM0 = 0xD2511F53;
+        constexpr uint64_t PhiloxM1 = 0xCD9E8D57;
+        constexpr uint32_t PhiloxW0 = 0x9E3779B9;     // Key schedule (golden ratio, sqrt(3) - 1)
+        constexpr uint32_t PhiloxW1 = 0xBB67AE85;
+        constexpr uint64_t Low32Mask = 0xffffffff;
+        constexpr uint64_t OneBits = 0x3ff0000000000000;
+
+        // sin((pi/2) r) / r and cos((pi/2) r) in z = r^2, |r| <= 1/2 (Taylor, truncation < 1e-19)
+        constexpr double SinHalfPi[9] = {
+            1.5707963267948966, -0.6459640975062463, 0.07969262624616705,
+            -0.004681754135318688, 0.00016044118478735983, -3.598843235212085e-06,
+            5.692172921967927e-08, -6.688035109811468e-10, 6.0669357311061955e-12
+        };
+        constexpr double CosHalfPi[10] = {
+            1.0, -1.2337005501361697, 0.25366950790104803,
+            -0.02086348076335296, 0.0009192602748394266, -2.5202042373060607e-05,
+            4.710874778818172e-07, -6.386603083791852e-09, 6.565963114979473e-11,
+            -5.294400200734623e-13
+        };
+
+        // 32-bit values held in 64-bit lanes (uint64_t on Scalar)
+        template <class V>
+        struct VecU64 {
+            typedef uint64_t type __attribute__((vector_size(sizeof(V))));
+        };
+
+        template <>
+        struct VecU64<double> {
+            typedef uint64_t type;
+        };
+
+        template <class V>
+        using VecU64T = typename VecU64<V>::type;
+
+        // Low 32 bits of a times low 32 bits of b, as a full 64-bit product per lane
+        template <class U>
+        FORCE_INLINE U mul_u32_wide(const U& a, const U& b) {
+            if constexpr (std::is_same_v<U, uint64_t>) {
+                return (a & Low32Mask) * (b & Low32Mask);
+            } else {
+                // GCC widens a u64 vector multiply to three vpmuludq; one suffices here
+                U r;
+                asm("vpmuludq %2, %1, %0" : "=v"(r) : "v"(a), "v"(b));
+                return r;
+            }
+        }
+
+        /**
+         * @brief Philox4x32-10 on one counter per lane, words in the low
+         * halves of c0..c3; the key (seed) is shared by all lanes.
+         */
+        template <class U>
+        FORCE_INLINE void philox4x32_10(U& c0, U& c1, U& c2, U& c3, uint64_t key) {
+            const U m0 = U{} + PhiloxM0;
+            const U m1 = U{} + PhiloxM1;
+            uint32_t k0 = static_cast<uint32_t>(key);
+            uint32_t k1 = static_cast<uint32_t>(key >> 32);
+            for (int round = 0; round < 10; ++round) {
+                const U p0 = mul_u32_wide(c0, m0);
+                const U p1 = mul_u32_wide(c2, m1);
+                const U n0 = (p1 >> 32) ^ c1 ^ k0;
+                const U n2 = (p0 >> 32) ^ c3 ^ k1;
+                c1 = p1 & Low32Mask;
+                c3 = p0 & Low32Mask;
+                c0 = n0;
+                c2 = n2;
+                k0 += PhiloxW0;
+                k1 += PhiloxW1;
+            }
+        }
+
+        // Top 52 bits as a double in [0, 1)
+        template <class V>
+        FORCE_INLINE V bits_to_unit(const VecU64T<V>& bits) {
+            const VecU64T<V> m = (bits >> 12) | OneBits;
+            if constexpr (std::is_same_v<V, double>) return std::bit_cast<double>(m) - 1.0;
+            else return (V)m - 1.0;
+        }
+
+        /**
+         * @brief sin and cos of 2 pi u for u in [0, 1): u is split exactly
+         * into a quadrant and |r| <= 1/2, so there is no pi rounding error.
+         */
+        template <class V>
+        FORCE_INLINE void sincos_2pi(const V& u, V& s, V& c) {
+            const V t = 4.0 * u + Shifter;
+            const VecIntT<V> q = as_bits(t);
+            const V r = 4.0 * u - (t - Shifter);
+            const V z = r * r;
+            const V sp = r * horner(z, SinHalfPi);
+            const V cp = horner(z, CosHalfPi);
+            // Quadrant q rotates (sin, cos) by q * 90 degrees
+            const auto odd = (q & 1) != 0;
+            const V s0 = odd ? cp : sp;
+            const V c0 = odd ? sp : cp;
+            s = from_bits<V>(as_bits(s0) ^ ((q & 2) << 62));
+            c = from_bits<V>(as_bits(c0) ^ (((q + 1) & 2) << 62));
+        }
+
+        template <class U, size_t... I>
+        FORCE_INLINE U lane_index(std::index_sequence<I...>) {
+            return U{I...};
+        }
+
+        constexpr int interleave_index(int j, int width, int half) {
+            return j % 2 == 0 ? half + j / 2 : width + half + j / 2;
+        }
+
+        template <class V, int... J>
+        FORCE_INLINE void store_interleaved(double* out, const V& a, const V& b, std::integer_sequence<int, J...>) {
+            constexpr int W = sizeof(V) / sizeof(double);
+            const V lo = __builtin_shufflevector(a, b, interleave_index(J, W, 0)...);
+            const V hi = __builtin_shufflevector(a, b, interleave_index(J, W, W / 2)...);
+            std::memcpy(out, &lo, sizeof(V));
+            std::memcpy(out + W, &hi, sizeof(V));
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Scalar Philox4x32-10 of one counter (reference / known-answer tests).
+     */
+    inline std::array<uint32_t, 4> philox4x32_10(const std::array<uint32_t, 4>& ctr, uint64_t key) {
+        uint64_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+        detail::philox4x32_10(c0, c1, c2, c3, key);
+        return {static_cast<uint32_t>(c0), static_cast<uint32_t>(c1), static_cast<uint32_t>(c2),
+                static_cast<uint32_t>(c3)};
+    }
+
+    /**
+     * @brief One Philox stream: (seed, stream id) and a block position.
+     * Array calls consume ceil(n / 2) blocks; an odd n drops the last value.
+     */
+    template <ISA Arch = CurrentArch, Accuracy Acc = Accuracy::Fast>
+    class Philox {
+    public:
+        using VM = VectorMath<Arch, Acc>;
+        using Reg = typename VM::Reg;
+        using Bits = detail::VecU64T<Reg>;
+        static constexpr size_t Width = VM::Width;
+
+        Philox(uint64_t seed, uint64_t stream, uint64_t block = 0)
+            : seed_(seed), stream_(stream), block_(block) {}
+
+        /**
+         * @brief The two 64-bit halves of block (block[k], stream[k]) per lane.
+         */
+        static FORCE_INLINE void bits(uint64_t seed, const Bits& block, const Bits& stream, Bits& lo, Bits& hi) {
+            Bits c0 = block & detail::Low32Mask;
+            Bits c1 = block >> 32;
+            Bits c2 = stream & detail::Low32Mask;
+            Bits c3 = stream >> 32;
+            detail::philox4x32_10(c0, c1, c2, c3, seed);
+            lo = c0 | (c1 << 32);
+            hi = c2 | (c3 << 32);
+        }
+
+        static FORCE_INLINE void uniform_pair(uint64_t seed, const Bits& block, const Bits& stream, Reg& u0,
+                                              Reg& u1) {
+            Bits lo, hi;
+            bits(seed, block, stream, lo, hi);
+            u0 = detail::bits_to_unit<Reg>(lo);
+            u1 = detail::bits_to_unit<Reg>(hi);
+        }
+
+        static FORCE_INLINE void normal_pair(uint64_t seed, const Bits& block, const Bits& stream, Reg& z0,
+                                             Reg& z1) {
+            Reg u0, u1;
+            uniform_pair(seed, block, stream, u0, u1);
+            // 1 - u0 is in (0, 1]: never log(0)
+            const Reg radius = VM::sqrt(-2.0 * VM::log(1.0 - u0));
+            Reg s, c;
+            detail::sincos_2pi(u1, s, c);
+            z0 = radius * c;
+            z1 = radius * s;
+        }
+
+        // block, block + 1, ... across the lanes
+        static FORCE_INLINE Bits consecutive(uint64_t block) {
+            if constexpr (Width == 1) return block;
+            else return block + detail::lane_index<Bits>(std::make_index_sequence<Width>{});
+        }
+
+        void uniform(double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("Philox<") + to_string(Arch) + ">::uniform");
+            generate<false>(out, n);
+        }
+
+        void normal(double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("Philox<") + to_string(Arch) + ">::normal");
+            generate<true>(out, n);
+        }
+
+        uint64_t seed() const { return seed_; }
+        uint64_t stream() const { return stream_; }
+        uint64_t block() const { return block_; }
+        void seek(uint64_t block) { block_ = block; }
+
+    private:
+        template <bool Normal>
+        void generate(double* out, size_t n) {
+            const uint64_t seed = seed_;
+            const uint64_t first = block_;
+            const Bits stream = Bits{} + stream_;
+            const size_t blocks = (n + 1) / 2;
+            VM::blocks(blocks, [&](size_t i, size_t count) __attribute__((always_inline)) {
+                Reg a, b;
+                if constexpr (Normal) normal_pair(seed, consecutive(first + i), stream, a, b);
+                else uniform_pair(seed, consecutive(first + i), stream, a, b);
+                double* dst = out + 2 * i;
+                if (count == Width && 2 * (i + count) <= n) {
+                    store_pair(dst, a, b);
+                } else {
+                    double tmp[2 * Width];
+                    store_pair(tmp, a, b);
+                    std::memcpy(dst, tmp, (n - 2 * i < 2 * count ? n - 2 * i : 2 * count) * sizeof(double));
+                }
+            });
+            block_ += blocks;
+        }
+
+        static FORCE_INLINE void store_pair(double* out, const Reg& a, const Reg& b) {
+            if constexpr (Width == 1) {
+                out[0] = a;
+                out[1] = b;
+            } else {
+                detail::store_interleaved(out, a, b, std::make_integer_sequence<int, static_cast<int>(Width)>{});
+            }
+        }
+
+        uint64_t seed_;
+        uint64_t stream_;
+        uint64_t block_;
+    };
+
+} // namespace simd
+} // namespace fwilliamsca
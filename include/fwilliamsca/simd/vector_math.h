@@ -0,0 +1,695 @@
+/**
+ * @file vector_math.h
+ * @brief Vectorized exp, log, log1p, sqrt, rsqrt, erf/erfc and normal CDF
+ * for every MathKernel tier.
+ * * std::exp/std::log are opaque libm calls (with errno side effects), so a
+ * loop over them never vectorizes and runs >10x slower than MathKernel::add
+ * next to it. These kernels evaluate a whole register per step: range
+ * reduction into a short interval, then a Chebyshev-fitted polynomial.
+ * No lookup tables (no gathers), no per-lane branches: special cases are blended.
+ *
+ * Two accuracy tiers; max error measured against long-double libm on 2*10^6
+ * points per function over its full domain (normal results), identical on
+ * every tier:
+ *
+ *   function     Accurate       Fast
+ *   exp          1.1 ULP        ~500 ULP    (rel. 7e-14)
+ *   log, log1p   1.6 ULP        ~700 ULP    (rel. 1.1e-13)
+ *   erf          1.2 ULP        ~1000 ULP   (rel. 1.3e-13)
+ *   erfc         5 ULP          ~4600 ULP   (rel. 6e-13)
+ *   norm_cdf     6 ULP          ~4600 ULP   (rel. 6e-13)
+ *   sqrt         correctly rounded in both tiers
+ *   rsqrt        1.5 ULP        2.4 ULP on AVX-512 tiers (rsqrt14 + Newton),
+ *                               Accurate elsewhere
+ *
+ * erfc/norm_cdf lose a few ULP to exp(-x^2) amplifying the argument's
+ * rounding; the Accurate tier splits x^2 exactly to keep that near 5 ULP.
+ *
+ * Algorithms are written once against GCC vector extensions: Reg is a
+ * zmm-sized vector on AVX512_F, ymm on AVX2/AVX512_VL and a double on
+ * Scalar; inlined into each tier's target-attributed loop the same source
+ * becomes that tier's instructions. Two layers:
+ * - Array kernels: VectorMath<Arch, Acc>::exp(x, out, n) and friends.
+ * - Register functions: VectorMath<Arch, Acc>::exp(reg), composed inside
+ *   map() to fuse several steps into one pass over memory:
+ *
+ *   struct Discount {   // out[i] = cf[i] * exp(-r[i] * t[i])
+ *       template <class R> FORCE_INLINE R operator()(const R& cf, const R& r, const R& t) const {
+ *           return cf * VectorMath<>::exp(-r * t);
+ *       }
+ *   };
+ *   VectorMath<>::map(out, n, Discount{}, cf, r, t);
+ *
+ * Register functions are only valid in code compiled for the tier (map()
+ * bodies, target-attributed kernels, or a -m build that covers it).
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include "intrinsics.h"
+
+// Register functions return 256/512-bit vectors, but only ever inline into
+// their tier's kernels, so GCC's ABI warning does not apply to them. GCC
+// reports it once per translation unit at the end of the file, outside any
+// push/pop region, so the suppression is file-scope: including this header
+// (or any header built on it) turns -Wpsabi off for the rest of the TU.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace fwilliamsca {
+namespace simd {
+
+    enum class Accuracy {
+        Fast,       // ~1e-13 relative (6e-13 for erfc/normal CDF): Monte Carlo, signals
+        Accurate    // <= 6 ULP (<= 1.6 ULP for exp/log): pricing, risk, reference comparisons
+    };
+
+    inline const char* to_string(Accuracy acc) {
+        return acc == Accuracy::Fast ? "Fast" : "Accurate";
+    }
+
+    // Register types per tier (GCC vector extensions; Scalar is a plain double)
+    typedef double VecF64x8 __attribute__((vector_size(64)));
+    typedef double VecF64x4 __attribute__((vector_size(32)));
+
+    template <ISA Arch>
+    struct VecTraits {
+        using Reg = double;
+    };
+
+    template <>
+    struct VecTraits<ISA::AVX512_F> {
+        using Reg = VecF64x8;
+    };
+
+    template <>
+    struct VecTraits<ISA::AVX512_VL> {
+        using Reg = VecF64x4;
+    };
+
+    template <>
+    struct VecTraits<ISA::AVX2> {
+        using Reg = VecF64x4;
+    };
+
+    namespace detail {
+
+        /**
+         * @brief Polynomial coefficients, lowest order first. Fitted by
+         * Chebyshev interpolation in long double; intervals in the comments.
+         */
+        template <Accuracy Acc>
+        struct VectorMathCoeffs;
+
+        template <>
+        struct VectorMathCoeffs<Accuracy::Accurate> {
+            // (e^r - 1 - r) / r^2, |r| <= ln2/2
+            static constexpr double Exp[10] = {
+                0.50000000000000011, 0.16666666666666666, 0.04166666666662415,
+                0.0083333333333316609, 0.0013888888917200403, 0.00019841269859218703,
+                2.4801521318036698e-05, 2.7557272194357395e-06, 2.7620077488519078e-07,
+                2.5099120890330658e-08
+            };
+            // (atanh(s)/s - 1) / s^2 in z = s^2 <= 0.0295
+            static constexpr double Log[7] = {
+                0.33333333333333354, 0.19999999999948812, 0.14285714313130907,
+                0.11111105557612248, 0.090914448277231663, 0.07665860476681062,
+                0.073081610191279137
+            };
+            // erf(z)/z - 1 in t = z^2, z < 0.84375
+            static constexpr double Erf[11] = {
+                0.12837916709551256, -0.37612638903183404, 0.11283791670935379,
+                -0.026866170640790381, 0.0052239775764612644, -0.00085483237950166417,
+                0.00012055200050842092, -1.4922123518108494e-05, 1.6401650668749148e-06,
+                -1.5714586864072896e-07, 1.0726895337743274e-08
+            };
+            // erfc(z) e^{z^2}: near in (z - NearCenter), mid/far z erfc(z) e^{z^2} in (1/z^2 - center)
+            static constexpr double ErfcNear[18] = {
+                0.31407958790963747, -0.15669544200007177, 0.071691326065773067,
+                -0.030531947994715068, 0.012231109505906005, -0.0046447801912640214,
+                0.0016820717120609142, -0.00058366442930184333, 0.00019480398897793528,
+                -6.2739358567317192e-05, 1.955057760720214e-05, -5.9084343632678931e-06,
+                1.7359559769552619e-06, -4.9625016575244857e-07, 1.3673949849023588e-07,
+                -3.7244484835044858e-08, 1.1610117588254876e-08, -3.0045466002938324e-09
+            };
+            static constexpr double ErfcMid[18] = {
+                0.53511470419939511, -0.21055575719462327, 0.21406709212885081,
+                -0.3201316223731443, 0.60184995690462961, -1.3232810339857426,
+                3.2672487325508603, -8.8301252293815491, 25.672503486022826,
+                -79.302354580177052, 257.70569103900243, -875.05170061416709,
+                3131.6958351125554, -11583.080953177961, 37070.627694134695,
+                -129818.61466020174, 1082489.60214151, -4944359.5933002094
+            };
+            static constexpr double ErfcFar[18] = {
+                0.55870902602705241, -0.26633184891660183, 0.36741043613173424,
+                -0.81633500637616019, 2.4577918087123298, -9.2219636843087258,
+                41.046921315029628, -209.80608295238571, 1202.1911880137084,
+                -7627.865292610405, 56261.087903529791, -402547.51038097509,
+                0.0, 0.0, 0.0,
+                0.0, 0.0, 0.0
+            };
+            static constexpr double MidBegin = 2.25;
+            static constexpr double FarBegin = 5.0;
+            static constexpr double NearCenter = 1.546875;
+            static constexpr double MidCenter = 0.12;
+            static constexpr double FarCenter = 0.02;
+        };
+
+        template <>
+        struct VectorMathCoeffs<Accuracy::Fast> {
+            static constexpr double Exp[8] = {
+                0.49999999999955108, 0.16666666666662588, 0.041666666786265738,
+                0.0083333333442021425, 0.0013888839110571939, 0.00019841224600904359,
+                2.4867870179709167e-05, 2.7617564235330552e-06
+            };
+            static constexpr double Log[5] = {
+                0.33333333333687537, 0.19999999398671839, 0.14285877267670258,
+                0.11095700425658017, 0.09681326725485094
+            };
+            static constexpr double Erf[9] = {
+                0.12837916709546854, -0.37612638902181594, 0.11283791633338926,
+                -0.026866165198962923, 0.0052239380298037307, -0.00085467040845822219,
+                0.00012016020240531808, -1.4364053531730865e-05, 1.2009505187292256e-06
+            };
+            static constexpr double ErfcNear[13] = {
+                0.33484946240551772, -0.17615100837590222, 0.08438474736434616,
+                -0.037444297474407411, 0.015571818773369314, -0.0061212391508606266,
+                0.0022893879838363019, -0.00081894294134498983, 0.00028129008985978244,
+                -9.2701144245231244e-05, 2.9666616404614559e-05, -1.0159230346044751e-05,
+                3.0410568338757745e-06
+            };
+            static constexpr double ErfcMid[13] = {
+                0.52898250585953877, -0.19851601115369352, 0.18818360934758172,
+                -0.25827453928945654, 0.44036818448759801, -0.86998568989767411,
+                1.9156511001406198, -4.5980646293535425, 11.797011334260008,
+                -30.41723381638656, 85.347200581659891, -376.63068522038202,
+                1195.249816274498
+            };
+            static constexpr double ErfcFar[13] = {
+                0.55738645150942823, -0.26271776885585285, 0.35552292349905912,
+                -0.76938643693741238, 2.2417727838977592, -8.0928356944163067,
+                34.444993636552901, -167.75478407473145, 966.09130121552892,
+                -5707.2999828743868, 0.0, 0.0,
+                0.0
+            };
+            static constexpr double MidBegin = 2.0;
+            static constexpr double FarBegin = 4.5;
+            static constexpr double NearCenter = 1.421875;
+            static constexpr double MidCenter = 0.15;
+            static constexpr double FarCenter = 0.025;
+        };
+
+        template <class V>
+        struct VecInt {
+            typedef int64_t type __attribute__((vector_size(sizeof(V))));
+        };
+
+        template <>
+        struct VecInt<double> {
+            typedef int64_t type;
+        };
+
+        template <class V>
+        using VecIntT = typename VecInt<V>::type;
+
+        constexpr double Shifter = 0x1.8p52;                 // x + Shifter rounds x to an integer
+        constexpr int64_t ShifterBits = 0x4338000000000000;
+        constexpr double Log2e = 0x1.71547652b82fep0;
+        constexpr double Ln2Hi = 0x1.62e42feep-1;           // 32 bits: n * Ln2Hi is exact
+        constexpr double Ln2Lo = 0x1.a39ef35793c76p-33;
+        constexpr double ErfNearBegin = 0.84375;             // erf polynomial below, erfc tail above
+        constexpr double ErfcMaxArg = 28.0;                  // erfc(28) underflows to 0
+        constexpr int64_t SqrtHalfBits = 0x3fe6a09e667f3bcd;
+        constexpr int64_t AbsMask = 0x7fffffffffffffff;
+        constexpr int64_t SignMask = std::numeric_limits<int64_t>::min();
+        constexpr int64_t ExponentMask = std::numeric_limits<int64_t>::min() >> 11;   // Sign + exponent
+        constexpr int64_t Low27Mask = ~int64_t(0x7ffffff);
+        constexpr double LogMaxZ = 0.029437251522859;        // (3 - 2 sqrt 2)^2: s^2 bound of the log fit
+
+        template <class V>
+        FORCE_INLINE V splat(double c) {
+            return V{} + c;
+        }
+
+        template <class V>
+        FORCE_INLINE VecIntT<V> as_bits(const V& x) {
+            if constexpr (std::is_same_v<V, double>) return std::bit_cast<int64_t>(x);
+            else return (VecIntT<V>)x;
+        }
+
+        template <class V>
+        FORCE_INLINE V from_bits(const VecIntT<V>& b) {
+            if constexpr (std::is_same_v<V, double>) return std::bit_cast<double>(b);
+            else return (V)b;
+        }
+
+        // Exact for |k| < 2^51 (no cvtqq2pd below AVX-512DQ)
+        template <class V>
+        FORCE_INLINE V int_to_double(const VecIntT<V>& k) {
+            return from_bits<V>(k + ShifterBits) - Shifter;
+        }
+
+        // Keeps the top 26 significant bits, so x * x is exact
+        template <class V>
+        FORCE_INLINE V truncate26(const V& x) {
+            return from_bits<V>(as_bits(x) & Low27Mask);
+        }
+
+        // Branch condition over a lane mask (bool for the scalar tier)
+        template <class M>
+        FORCE_INLINE bool all_lanes(const M& m) {
+            if constexpr (std::is_same_v<M, bool>) {
+                return m;
+            } else {
+                int64_t lanes[sizeof(M) / sizeof(int64_t)];
+                std::memcpy(lanes, &m, sizeof(M));
+                int64_t all = -1;
+                for (int64_t l : lanes) all &= l;
+                return all == -1;
+            }
+        }
+
+        template <class V, size_t N>
+        FORCE_INLINE V horner(const V& u, const double (&c)[N]) {
+            V p = splat<V>(c[N - 1]);
+            for (size_t k = N - 1; k-- > 0;) p = p * u + c[k];
+            return p;
+        }
+
+        // Horner with the coefficient set chosen per lane
+        template <class V, class M, size_t N>
+        FORCE_INLINE V horner3(const V& u, const M& use_c, const M& use_b,
+                               const double (&a)[N], const double (&b)[N], const double (&c)[N]) {
+            V p = use_c ? splat<V>(c[N - 1]) : (use_b ? splat<V>(b[N - 1]) : splat<V>(a[N - 1]));
+            for (size_t k = N - 1; k-- > 0;) {
+                p = p * u + (use_c ? splat<V>(c[k]) : (use_b ? splat<V>(b[k]) : splat<V>(a[k])));
+            }
+            return p;
+        }
+
+        template <class V>
+        FORCE_INLINE V vm_sqrt(const V& x) {
+            if constexpr (std::is_same_v<V, double>) {
+                return __builtin_sqrt(x);
+            } else {
+                // vsqrtpd has no generic-vector builtin; the register width follows V
+                V r;
+                asm("vsqrtpd %1, %0" : "=v"(r) : "v"(x));
+                return r;
+            }
+        }
+
+        template <Accuracy Acc, class V>
+        FORCE_INLINE V vm_exp(const V& x) {
+            using C = VectorMathCoeffs<Acc>;
+            // Past the clamps the result is 0 or inf anyway; NaN passes through
+            V xc = x < -746.0 ? splat<V>(-746.0) : x;
+            xc = xc > 710.0 ? splat<V>(710.0) : xc;
+
+            // x = n ln2 + r, |r| <= ln2/2
+            const V t = xc * Log2e + Shifter;
+            const V n = t - Shifter;
+            const VecIntT<V> ni = as_bits(t) - ShifterBits;
+            V r = xc - n * Ln2Hi;
+            r = r - n * Ln2Lo;
+
+            const V p = 1.0 + (r + r * r * horner(r, C::Exp));
+
+            // 2^n in two halves: both stay normal for n in [-1076, 1024]
+            const VecIntT<V> n1 = ni >> 1;
+            const VecIntT<V> n2 = ni - n1;
+            return p * from_bits<V>((n1 + 1023) << 52) * from_bits<V>((n2 + 1023) << 52);
+        }
+
+        template <Accuracy Acc, class V>
+        FORCE_INLINE V vm_log(const V& x) {
+            using C = VectorMathCoeffs<Acc>;
+            // Subnormals: scale into the normal range first
+            const auto tiny = x < 0x1p-1022;
+            const V xs = tiny ? x * 0x1p52 : x;
+
+            // x = 2^k m, m in [sqrt(1/2), sqrt(2)): f = m - 1 is exact
+            const VecIntT<V> bits = as_bits(xs);
+            const VecIntT<V> tmp = bits - SqrtHalfBits;
+            const VecIntT<V> k = tmp >> 52;
+            const V m = from_bits<V>(bits - (tmp & ExponentMask));
+            const V e = int_to_double<V>(k) - (tiny ? splat<V>(52.0) : splat<V>(0.0));
+
+            // log(1 + f) = 2 atanh(s), s = f / (2 + f); 2s = f - s f keeps f exact
+            const V f = m - 1.0;
+            const V s = f / (2.0 + f);
+            const V z = s * s;
+            const V lg = f - s * (f - 2.0 * z * horner(z, C::Log));
+            const V r = e * Ln2Hi + (lg + e * Ln2Lo);
+
+            const V inf = splat<V>(std::numeric_limits<double>::infinity());
+            const V special = x == 0.0 ? -inf : (x == inf ? inf : splat<V>(std::numeric_limits<double>::quiet_NaN()));
+            return ((x > 0.0) & (x < inf)) ? r : special;
+        }
+
+        template <Accuracy Acc, class V>
+        FORCE_INLINE V vm_log1p(const V& x) {
+            const V u = 1.0 + x;
+            // log1p(x) = log(u) + (x - (u - 1)) / u: restores what rounding 1 + x lost
+            const V c = (x - (u - 1.0)) / u;
+            const V inf = splat<V>(std::numeric_limits<double>::infinity());
+            return vm_log<Acc>(u) + (((u > 0.0) & (u < inf)) ? c : splat<V>(0.0));
+        }
+
+        /**
+         * @brief log(p1 / p0) with one division: 2 atanh(s), s = (p1 - p0) / (p1 + p0).
+         * p1 - p0 is exact for ratios in [1/2, 2]. A register with any ratio outside
+         * [sqrt(1/2), sqrt(2)] (or a non-positive price) falls back to log(p1 / p0),
+         * which is as accurate once |log ratio| > 0.34.
+         */
+        template <Accuracy Acc, class V>
+        FORCE_INLINE V vm_log_ratio(const V& p0, const V& p1) {
+            const V d = p1 - p0;
+            const V s = d / (p1 + p0);
+            const V z = s * s;
+            const auto near = z <= LogMaxZ;
+            const V r = 2.0 * s + 2.0 * s * z * horner(z, VectorMathCoeffs<Acc>::Log);
+            if (__builtin_expect(all_lanes(near), 1)) return r;
+            return near ? r : vm_log<Acc>(p1 / p0);
+        }
+
+        /**
+         * @brief erfc(z) for z in [0.84375, 28], given z^2 = sq_hi + sq_lo
+         * with sq_hi exact. Other lanes return garbage.
+         */
+        template <Accuracy Acc, class V>
+        FORCE_INLINE V erfc_tail(const V& z, const V& sq_hi, const V& sq_lo) {
+            using C = VectorMathCoeffs<Acc>;
+            const V w = 1.0 / z;
+            const V y = w * w;
+            const auto mid = z >= C::MidBegin;
+            const auto far = z >= C::FarBegin;
+            const V u = far ? y - C::FarCenter : (mid ? y - C::MidCenter : z - C::NearCenter);
+            V g = horner3(u, far, mid, C::ErfcNear, C::ErfcMid, C::ErfcFar);
+            g = mid ? g * w : g;
+
+            // e^{-z^2} = e^{-sq_hi} e^{-sq_lo}; |sq_lo| < 2^-25 z^2, so three terms suffice
+            const V elo = 1.0 - sq_lo * (1.0 - sq_lo * (0.5 - sq_lo * (1.0 / 6.0)));
+            return vm_exp<Acc>(-sq_hi) * elo * g;
+        }
+
+        // 1 - erfc(z) tail and its near-zero polynomial, for z = |x| already clamped
+        template <Accuracy Acc, class V>
+        FORCE_INLINE V erf_near(const V& z) {
+            return z + z * horner(z * z, VectorMathCoeffs<Acc>::Erf);
+        }
+
+        template <Accuracy Acc, class V>
+        FORCE_INLINE V vm_erf(const V& x) {
+            const V z = from_bits<V>(as_bits(x) & AbsMask);
+            const V zc = z > ErfcMaxArg ? splat<V>(ErfcMaxArg) : z;
+            const V s = truncate26(zc);
+            const V tail = 1.0 - erfc_tail<Acc>(zc, s * s, (zc - s) * (zc + s));
+            const V r = z < ErfNearBegin ? erf_near<Acc>(z) : tail;
+            return from_bits<V>(as_bits(r) | (as_bits(x) & SignMask));
+        }
+
+        template <Accuracy Acc, class V>
+        FORCE_INLINE V vm_erfc(const V& x) {
+            const V z = from_bits<V>(as_bits(x) & AbsMask);
+            const V zc = z > ErfcMaxArg ? splat<V>(ErfcMaxArg) : z;
+            const V s = truncate26(zc);
+            const V tail = erfc_tail<Acc>(zc, s * s, (zc - s) * (zc + s));
+            const V r = z < ErfNearBegin ? 1.0 - erf_near<Acc>(z) : tail;
+            return x < 0.0 ? 2.0 - r : r;
+        }
+
+        template <Accuracy Acc, class V>
+        FORCE_INLINE V vm_norm_cdf(const V& x) {
+            // Phi(-a) = erfc(a / sqrt 2) / 2, with a^2 / 2 split from a itself so
+            // rounding a / sqrt 2 does not reach the exponent (deep left tail)
+            const V a = from_bits<V>(as_bits(x) & AbsMask);
+            const V ac = a > ErfcMaxArg * 1.4142135623730951 ? splat<V>(ErfcMaxArg * 1.4142135623730951) : a;
+            const V z = ac * 0.70710678118654752;
+            const V s = truncate26(ac);
+            const V tail = erfc_tail<Acc>(z, 0.5 * (s * s), 0.5 * ((ac - s) * (ac + s)));
+            const V q = 0.5 * (z < ErfNearBegin ? 1.0 - erf_near<Acc>(z) : tail);
+            return x < 0.0 ? q : 1.0 - q;
+        }
+
+        template <Accuracy Acc, bool HasRsqrt14, class V>
+        FORCE_INLINE V vm_rsqrt(const V& x) {
+            if constexpr (Acc == Accuracy::Fast && HasRsqrt14) {
+                // 14-bit estimate, two Newton steps (14 -> 28 -> 53 bits);
+                // subnormals are scaled up first, as the estimate flushes them
+                const auto tiny = x < 0x1p-1022;
+                const V xs = tiny ? x * 0x1p52 : x;
+                V y;
+                asm("vrsqrt14pd %1, %0" : "=v"(y) : "v"(xs));
+                const V h = 0.5 * xs;
+                V r = y * (1.5 - h * y * y);
+                r = r * (1.5 - h * r * r);
+                r = tiny ? r * 0x1p26 : r;
+                // 0, inf and negatives: the estimate is already exact (inf, 0, NaN)
+                const V inf = splat<V>(std::numeric_limits<double>::infinity());
+                return ((x > 0.0) & (x < inf)) ? r : y;
+            } else {
+                return 1.0 / vm_sqrt(x);
+            }
+        }
+
+        template <class V>
+        FORCE_INLINE V load_reg(const double* p) {
+            V v;
+            std::memcpy(&v, p, sizeof(V));
+            return v;
+        }
+
+        // Lanes past `count` read as 1.0, which every op maps to a finite value
+        template <class V>
+        FORCE_INLINE V load_partial(const double* p, size_t count) {
+            V v = splat<V>(1.0);
+            std::memcpy(&v, p, count * sizeof(double));
+            return v;
+        }
+
+        template <class V, class F, class... In>
+        FORCE_INLINE void map_loop(double* out, size_t n, const F& f, const In*... in) {
+            constexpr size_t W = sizeof(V) / sizeof(double);
+            size_t i = 0;
+            for (; i + W <= n; i += W) {
+                const V r = f(load_reg<V>(in + i)...);
+                std::memcpy(out + i, &r, sizeof(V));
+            }
+            if (i < n) {
+                const V r = f(load_partial<V>(in + i, n - i)...);
+                std::memcpy(out + i, &r, (n - i) * sizeof(double));
+            }
+        }
+
+        // f(i, W) per full register, then f(i, n - i) once for the tail
+        template <class V, class F>
+        FORCE_INLINE void block_loop(size_t n, const F& f) {
+            constexpr size_t W = sizeof(V) / sizeof(double);
+            size_t i = 0;
+            for (; i + W <= n; i += W) f(i, W);
+            if (i < n) f(i, n - i);
+        }
+
+        /**
+         * @brief One map loop per tier with the tier's target attribute;
+         * flatten pulls the op (and any user functor) into it.
+         */
+        template <ISA Arch>
+        struct VectorLoop {
+            template <class F, class... In>
+            static __attribute__((flatten)) inline void map(double* out, size_t n, const F& f, const In*... in) {
+                map_loop<typename VecTraits<Arch>::Reg>(out, n, f, in...);
+            }
+            template <class F>
+            static __attribute__((flatten)) inline void blocks(size_t n, const F& f) {
+                block_loop<typename VecTraits<Arch>::Reg>(n, f);
+            }
+        };
+
+        template <>
+        struct VectorLoop<ISA::AVX512_F> {
+            template <class F, class... In>
+            static KERNEL_AVX512 __attribute__((flatten)) void map(double* out, size_t n, const F& f, const In*... in) {
+                map_loop<VecF64x8>(out, n, f, in...);
+            }
+            template <class F>
+            static KERNEL_AVX512 __attribute__((flatten)) void blocks(size_t n, const F& f) {
+                block_loop<VecF64x8>(n, f);
+            }
+        };
+
+        template <>
+        struct VectorLoop<ISA::AVX512_VL> {
+            template <class F, class... In>
+            static KERNEL_AVX512_VL __attribute__((flatten)) void map(double* out, size_t n, const F& f, const In*... in) {
+                map_loop<VecF64x4>(out, n, f, in...);
+            }
+            template <class F>
+            static KERNEL_AVX512_VL __attribute__((flatten)) void blocks(size_t n, const F& f) {
+                block_loop<VecF64x4>(n, f);
+            }
+        };
+
+        template <>
+        struct VectorLoop<ISA::AVX2> {
+            template <class F, class... In>
+            static KERNEL_AVX2 __attribute__((flatten)) void map(double* out, size_t n, const F& f, const In*... in) {
+                map_loop<VecF64x4>(out, n, f, in...);
+            }
+            template <class F>
+            static KERNEL_AVX2 __attribute__((flatten)) void blocks(size_t n, const F& f) {
+                block_loop<VecF64x4>(n, f);
+            }
+        };
+
+    } // namespace detail
+
+    /**
+     * @brief Transcendental kernels for one ISA tier and accuracy tier.
+     * Array forms read n inputs and write n outputs (in place is fine).
+     */
+    template <ISA Arch = CurrentArch, Accuracy Acc = Accuracy::Accurate>
+    struct VectorMath {
+        using Reg = typename VecTraits<Arch>::Reg;
+        static constexpr size_t Width = sizeof(Reg) / sizeof(double);
+        static constexpr bool HasRsqrt14 = Arch == ISA::AVX512_F || Arch == ISA::AVX512_VL;
+
+        // Register forms (see the file comment for where they may be used)
+        static FORCE_INLINE Reg exp(const Reg& x) { return detail::vm_exp<Acc>(x); }
+        static FORCE_INLINE Reg log(const Reg& x) { return detail::vm_log<Acc>(x); }
+        static FORCE_INLINE Reg log1p(const Reg& x) { return detail::vm_log1p<Acc>(x); }
+        static FORCE_INLINE Reg sqrt(const Reg& x) { return detail::vm_sqrt(x); }
+        static FORCE_INLINE Reg rsqrt(const Reg& x) { return detail::vm_rsqrt<Acc, HasRsqrt14>(x); }
+        static FORCE_INLINE Reg erf(const Reg& x) { return detail::vm_erf<Acc>(x); }
+        static FORCE_INLINE Reg erfc(const Reg& x) { return detail::vm_erfc<Acc>(x); }
+        static FORCE_INLINE Reg norm_cdf(const Reg& x) { return detail::vm_norm_cdf<Acc>(x); }
+
+        /**
+         * @brief out[i] = f(in0[i], in1[i], ...) one register at a time.
+         * f takes and returns Reg (a template call operator works on every tier).
+         */
+        template <class F, class... In>
+        static void map(double* out, size_t n, const F& f, const In*... in) {
+            detail::VectorLoop<Arch>::map(out, n, f, in...);
+        }
+
+        /**
+         * @brief Calls f(i, count) for each register-sized block of [0, n):
+         * count is Width except for a shorter final block. For kernels with
+         * several outputs; f does its own load()/store(). f must inline into
+         * the tier's loop: a FORCE_INLINE functor, or a lambda declared
+         * `[&](size_t i, size_t count) __attribute__((always_inline)) { ... }`.
+         */
+        template <class F>
+        static void blocks(size_t n, const F& f) {
+            detail::VectorLoop<Arch>::blocks(n, f);
+        }
+
+        // Lanes past count read as 1.0 (see load_partial)
+        static FORCE_INLINE Reg load(const double* p, size_t count = Width) {
+            return count == Width ? detail::load_reg<Reg>(p) : detail::load_partial<Reg>(p, count);
+        }
+
+        static FORCE_INLINE void store(double* p, const Reg& r, size_t count = Width) {
+            std::memcpy(p, &r, count * sizeof(double));
+        }
+
+        static FORCE_INLINE Reg broadcast(double c) { return detail::splat<Reg>(c); }
+
+        // Lane masks from Reg comparisons (bool on Scalar); combine with && || !
+        using Mask = decltype(Reg{} < Reg{});
+
+        static FORCE_INLINE bool all(const Mask& m) { return detail::all_lanes(m); }
+        static FORCE_INLINE bool any(const Mask& m) { return !detail::all_lanes(!m); }
+
+        static void exp(const double* x, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("VectorMath<") + to_string(Arch) + ">::exp");
+            map(out, n, ExpOp{}, x);
+        }
+
+        static void log(const double* x, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("VectorMath<") + to_string(Arch) + ">::log");
+            map(out, n, LogOp{}, x);
+        }
+
+        static void log1p(const double* x, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("VectorMath<") + to_string(Arch) + ">::log1p");
+            map(out, n, Log1pOp{}, x);
+        }
+
+        static void sqrt(const double* x, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("VectorMath<") + to_string(Arch) + ">::sqrt");
+            map(out, n, SqrtOp{}, x);
+        }
+
+        static void rsqrt(const double* x, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("VectorMath<") + to_string(Arch) + ">::rsqrt");
+            map(out, n, RsqrtOp{}, x);
+        }
+
+        static void erf(const double* x, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("VectorMath<") + to_string(Arch) + ">::erf");
+            map(out, n, ErfOp{}, x);
+        }
+
+        static void erfc(const double* x, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("VectorMath<") + to_string(Arch) + ">::erfc");
+            map(out, n, ErfcOp{}, x);
+        }
+
+        static void norm_cdf(const double* x, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("VectorMath<") + to_string(Arch) + ">::norm_cdf");
+            map(out, n, NormCdfOp{}, x);
+        }
+
+        /**
+         * @brief out[i] = log(prices[i + 1] / prices[i]) for i < n - 1.
+         * Nearby prices take 2 atanh((p1 - p0) / (p1 + p0)): one division, and
+         * the exact difference keeps small returns at full relative precision.
+         */
+        static void log_returns(const double* prices, double* out, size_t n) {
+            FWILLIAMSCA_TRACE_SCOPE(std::string("VectorMath<") + to_string(Arch) + ">::log_returns");
+            if (n < 2) return;
+            map(out, n - 1, LogReturnOp{}, prices, prices + 1);
+        }
+
+    private:
+        struct ExpOp {
+            FORCE_INLINE Reg operator()(const Reg& x) const { return exp(x); }
+        };
+        struct LogOp {
+            FORCE_INLINE Reg operator()(const Reg& x) const { return log(x); }
+        };
+        struct Log1pOp {
+            FORCE_INLINE Reg operator()(const Reg& x) const { return log1p(x); }
+        };
+        struct SqrtOp {
+            FORCE_INLINE Reg operator()(const Reg& x) const { return sqrt(x); }
+        };
+        struct RsqrtOp {
+            FORCE_INLINE Reg operator()(const Reg& x) const { return rsqrt(x); }
+        };
+        struct ErfOp {
+            FORCE_INLINE Reg operator()(const Reg& x) const { return erf(x); }
+        };
+        struct ErfcOp {
+            FORCE_INLINE Reg operator()(const Reg& x) const { return erfc(x); }
+        };
+        struct NormCdfOp {
+            FORCE_INLINE Reg operator()(const Reg& x) const { return norm_cdf(x); }
+        };
+        struct LogReturnOp {
+            FORCE_INLINE Reg operator()(const Reg& p0, const Reg& p1) const { return detail::vm_log_ratio<Acc>(p0, p1); }
+        };
+    };
+
+} // namespace simd
+} // namespace fwilliamsca
@@ -0,0 +1,66 @@
+/**
+ * @file core_frequency.h
+ * @brief Effective core clock from a dependent-add chain.
+ * * The TSC ticks at a fixed reference rate, so it cannot see the core
+ * slowing down under an AVX-512 frequency license or speeding up in turbo.
+ * A chain of dependent register-register adds retires one add per core
+ * cycle on every x86 core since P6, so adds / elapsed-TSC-time is the clock
+ * the calling code actually ran at -- no MSR or PMU access required.
+ *
+ * A probe of a few thousand adds lasts ~1 us: short enough to sample the
+ * clock right after a kernel, before the license relaxes (~0.5-2 ms).
+ * Interrupts or preemption inside the window read as a low frequency;
+ * take the median of several probes.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "tsc_clock.h"
+
+namespace fwilliamsca {
+namespace timing {
+
+    /**
+     * @brief Executes `adds` (rounded down to a multiple of 8) dependent
+     * 1-cycle adds. Returns the chain value so it cannot be elided.
+     */
+    inline uint64_t dependent_add_chain(uint64_t adds) {
+        uint64_t acc = 0;
+        uint64_t loops = adds / 8;
+        if (loops == 0) return acc;
+        // Eight adds per loop trip keep the chain, not the loop counter, as the bottleneck.
+        // Register operand: Golden Cove and later fold add-immediate chains at rename
+        asm volatile(
+            "1:\n\t"
+            "add %2, %0\n\t"
+            "add %2, %0\n\t"
+            "add %2, %0\n\t"
+            "add %2, %0\n\t"
+            "add %2, %0\n\t"
+            "add %2, %0\n\t"
+            "add %2, %0\n\t"
+            "add %2, %0\n\t"
+            "dec %1\n\t"
+            "jnz 1b"
+            : "+r"(acc), "+r"(loops)
+            : "r"(uint64_t(1))
+            : "cc");
+        return acc;
+    }
+
+    /**
+     * @brief Core clock (GHz) over one chain of `adds` cycles.
+     */
+    inline double effective_core_ghz(uint64_t adds = 2048) {
+        const TscClock& tsc = TscClock::instance();
+        const uint64_t t0 = rdtsc_start();
+        const uint64_t done = dependent_add_chain(adds);
+        const uint64_t t1 = rdtsc_stop();
+        const double ns = tsc.elapsed_ns(t0, t1);
+        return ns > 0.0 ? static_cast<double>(done) / ns : 0.0;
+    }
+
+} // namespace timing
+} // namespace fwilliamsca
@@ -0,0 +1,430 @@
+/**
+ * @file trace.h
+ * @brief Hot-path trace points with Chrome/Perfetto trace JSON export.
+ * * When one tick goes slow, counters say that something was slow but not
+ * which stage. Trace points record (TSC, event id, duration) into a
+ * per-thread single-producer buffer; a TraceSession's background thread
+ * drains every buffer and writes the Chrome trace-event format, which
+ * chrome://tracing and ui.perfetto.dev open directly.
+ * - Recording is a relaxed flag check, an rdtsc and a 24-byte store into a
+ *   thread-local ring (no locks, no allocation after the thread's first event).
+ * - A full buffer drops the event and counts it; the hot path never waits.
+ * - Without -DFWILLIAMSCA_TRACE every macro expands to nothing, so trace
+ *   points can stay in kernels and rings permanently.
+ *
+ * Usage:
+ *   FWILLIAMSCA_TRACE_SCOPE("book.update");        // duration of this scope
+ *   FWILLIAMSCA_TRACE_INSTANT("risk.reject");      // point event
+ *   FWILLIAMSCA_TRACE_MARK(t0);                    // conditional span:
+ *   if (n != 0) FWILLIAMSCA_TRACE_COMPLETE("ring.pop_bulk", t0);
+ *
+ *   trace::TraceSession session("trace.json");     // records while alive
+ */
+
+#pragma once
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../detail/json.h"
+#include "../timing/tsc_clock.h"
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+namespace fwilliamsca {
+namespace trace {
+
+    enum class Phase : uint32_t {
+        Complete,   // Span: tsc = begin, duration = ticks ("X")
+        Instant     // Point event ("i")
+    };
+
+    struct Event {
+        uint64_t tsc;
+        uint64_t duration;
+        uint32_t id;
+        Phase phase;
+    };
+
+    /**
+     * @brief Per-thread SPSC event ring: the owning thread records, the
+     * session's flusher drains.
+     */
+    class ThreadBuffer {
+    public:
+        static constexpr size_t Capacity = size_t(1) << 15;
+
+        ThreadBuffer(uint32_t tid, std::string name)
+            : tid_(tid), name_(std::move(name)), events_(new Event[Capacity]) {}
+
+        FORCE_INLINE void record(uint32_t id, Phase phase, uint64_t tsc, uint64_t duration) {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            const size_t next = (tail + 1) & (Capacity - 1);
+            if (next == head_cache_) {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if (next == head_cache_) {
+                    dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            events_[tail] = Event{tsc, duration, id, phase};
+            tail_.store(next, std::memory_order_release);
+        }
+
+        /**
+         * @brief Consumer side: appends every pending event to out.
+         */
+        size_t drain(std::vector<Event>& out) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            const size_t tail = tail_.load(std::memory_order_acquire);
+            size_t n = 0;
+            while (head != tail) {
+                out.push_back(events_[head]);
+                head = (head + 1) & (Capacity - 1);
+                ++n;
+            }
+            head_.store(head, std::memory_order_release);
+            return n;
+        }
+
+        bool empty() const {
+            return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+        }
+
+        uint32_t tid() const { return tid_; }
+        const std::string& name() const { return name_; }
+        void set_name(std::string name) { name_ = std::move(name); }
+        uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+        // Set when the owning thread exits; the buffer is freed once drained
+        std::atomic<bool> retired{false};
+
+    private:
+        // Consumer-owned
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+
+        // Producer-owned
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+        size_t head_cache_ = 0;
+        std::atomic<uint64_t> dropped_{0};
+
+        alignas(CACHE_LINE_SIZE) uint32_t tid_;
+        std::string name_;
+        std::unique_ptr<Event[]> events_;
+    };
+
+    namespace detail {
+
+        struct Registry {
+            std::mutex mutex;
+            std::deque<std::string> names;                      // Index = id - 1 (stable storage)
+            std::unordered_map<std::string, uint32_t> ids;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        };
+
+        inline Registry& registry() {
+            static Registry r;
+            return r;
+        }
+
+        inline std::atomic<bool>& enabled_flag() {
+            static std::atomic<bool> flag{false};
+            return flag;
+        }
+
+        // Marks the buffer retired when its thread exits
+        struct ThreadHandle {
+            std::shared_ptr<ThreadBuffer> buffer;
+            ~ThreadHandle() {
+                if (buffer) buffer->retired.store(true, std::memory_order_release);
+            }
+        };
+
+        // Constant-initialized, so the hot path reads it without a TLS init guard
+        inline thread_local ThreadBuffer* current_buffer = nullptr;
+
+        inline ThreadBuffer& create_thread_buffer() {
+            thread_local ThreadHandle handle;
+            const uint32_t tid = static_cast<uint32_t>(syscall(SYS_gettid));
+            handle.buffer = std::make_shared<ThreadBuffer>(tid, "thread-" + std::to_string(tid));
+            {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.buffers.push_back(handle.buffer);
+            }
+            current_buffer = handle.buffer.get();
+            return *current_buffer;
+        }
+
+        FORCE_INLINE ThreadBuffer& this_thread_buffer() {
+            ThreadBuffer* b = current_buffer;
+            return b ? *b : create_thread_buffer();
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Interns an event name; call once per trace point (the macros
+     * cache the id in a function-local static).
+     */
+    inline uint32_t register_event(const std::string& name) {
+        detail::Registry& r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        auto it = r.ids.find(name);
+        if (it != r.ids.end()) return it->second;
+        r.names.push_back(name);
+        const uint32_t id = static_cast<uint32_t>(r.names.size());
+        r.ids.emplace(name, id);
+        return id;
+    }
+
+    inline std::string event_name(uint32_t id) {
+        detail::Registry& r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        return id >= 1 && id <= r.names.size() ? r.names[id - 1] : "?";
+    }
+
+    /**
+     * @brief True while a TraceSession is recording.
+     */
+    FORCE_INLINE bool enabled() {
+        return detail::enabled_flag().load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Names the calling thread in the trace (also allocates its buffer
+     * up front, keeping that allocation off the first traced hot path).
+     */
+    inline void set_thread_name(const std::string& name) {
+        ThreadBuffer& buffer = detail::this_thread_buffer();
+        std::lock_guard<std::mutex> lock(detail::registry().mutex);
+        buffer.set_name(name);
+    }
+
+    FORCE_INLINE uint64_t mark() {
+        return enabled() ? timing::rdtsc() : 0;
+    }
+
+    FORCE_INLINE void complete(uint32_t id, uint64_t begin_tsc) {
+        if (!enabled() || begin_tsc == 0) return;
+        const uint64_t now = timing::rdtsc();
+        detail::this_thread_buffer().record(id, Phase::Complete, begin_tsc, now - begin_tsc);
+    }
+
+    FORCE_INLINE void instant(uint32_t id) {
+        if (!enabled()) return;
+        detail::this_thread_buffer().record(id, Phase::Instant, timing::rdtsc(), 0);
+    }
+
+    /**
+     * @brief RAII span; emits one Complete event on destruction.
+     */
+    class Scope {
+    public:
+        explicit FORCE_INLINE Scope(uint32_t id) : id_(id), begin_(mark()) {}
+        FORCE_INLINE ~Scope() { complete(id_, begin_); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        uint32_t id_;
+        uint64_t begin_;
+    };
+
+    /**
+     * @brief Enables recording and streams events to a Chrome trace JSON
+     * file from a background thread until stop() / destruction. One session
+     * at a time.
+     */
+    class TraceSession {
+    public:
+        explicit TraceSession(const std::string& path,
+                              std::chrono::milliseconds flush_interval = std::chrono::milliseconds(10))
+            : flush_interval_(flush_interval) {
+            file_ = std::fopen(path.c_str(), "w");
+            if (!file_) return;
+            std::fprintf(file_, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+            // Discard events left over from an earlier session
+            std::vector<Event> stale;
+            for (auto& b : snapshot_buffers()) b->drain(stale);
+
+            const timing::TscClock& clock = timing::TscClock::instance();
+            ticks_per_us_ = clock.ticks_per_ns() * 1e3;
+            base_tsc_ = timing::rdtsc();
+            pid_ = static_cast<uint32_t>(getpid());
+            detail::enabled_flag().store(true, std::memory_order_release);
+            flusher_ = std::thread([this]() { run(); });
+        }
+
+        ~TraceSession() { stop(); }
+
+        TraceSession(const TraceSession&) = delete;
+        TraceSession& operator=(const TraceSession&) = delete;
+
+        bool ok() const { return file_ != nullptr; }
+
+        /**
+         * @brief Disables recording, writes the remaining events and closes the file.
+         */
+        void stop() {
+            if (!file_) return;
+            detail::enabled_flag().store(false, std::memory_order_release);
+            stop_.store(true, std::memory_order_release);
+            if (flusher_.joinable()) flusher_.join();
+            flush();
+            for (const auto& named : named_) {
+                write_separator();
+                std::fprintf(file_, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,"
+                                    "\"args\":{\"name\":\"%s\"}}",
+                             pid_, named.first, fwilliamsca::detail::json_escape(named.second).c_str());
+            }
+            std::fprintf(file_, "\n]}\n");
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+
+        uint64_t events_written() const { return written_; }
+
+        /**
+         * @brief Events dropped on full thread buffers (all threads, all sessions).
+         */
+        uint64_t dropped() const {
+            uint64_t total = 0;
+            for (auto& b : snapshot_buffers()) total += b->dropped();
+            return total;
+        }
+
+    private:
+        static std::vector<std::shared_ptr<ThreadBuffer>> snapshot_buffers() {
+            detail::Registry& r = detail::registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            return r.buffers;
+        }
+
+        void run() {
+            while (!stop_.load(std::memory_order_acquire)) {
+                std::this_thread::sleep_for(flush_interval_);
+                flush();
+            }
+        }
+
+        void write_separator() {
+            std::fprintf(file_, first_ ? "\n" : ",\n");
+            first_ = false;
+        }
+
+        void flush() {
+            std::vector<Event> events;
+            for (auto& b : snapshot_buffers()) {
+                events.clear();
+                if (b->drain(events) != 0) remember_thread(*b);
+                for (const Event& e : events) {
+                    const double ts = static_cast<double>(static_cast<int64_t>(e.tsc - base_tsc_)) / ticks_per_us_;
+                    write_separator();
+                    if (e.phase == Phase::Complete) {
+                        std::fprintf(file_, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u}",
+                                     name_of(e.id).c_str(), ts, static_cast<double>(e.duration) / ticks_per_us_,
+                                     pid_, b->tid());
+                    } else {
+                        std::fprintf(file_, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u}",
+                                     name_of(e.id).c_str(), ts, pid_, b->tid());
+                    }
+                    ++written_;
+                }
+            }
+            std::fflush(file_);
+            release_retired();
+        }
+
+        void remember_thread(const ThreadBuffer& b) {
+            for (const auto& named : named_) {
+                if (named.first == b.tid()) return;
+            }
+            std::lock_guard<std::mutex> lock(detail::registry().mutex);
+            named_.emplace_back(b.tid(), b.name());
+        }
+
+        // JSON-escaped event name, cached per id
+        const std::string& name_of(uint32_t id) {
+            auto it = names_.find(id);
+            if (it == names_.end()) it = names_.emplace(id, fwilliamsca::detail::json_escape(event_name(id))).first;
+            return it->second;
+        }
+
+        // Frees buffers whose threads have exited and that are fully drained
+        static void release_retired() {
+            detail::Registry& r = detail::registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (size_t i = 0; i < r.buffers.size();) {
+                if (r.buffers[i]->retired.load(std::memory_order_acquire) && r.buffers[i]->empty()) {
+                    r.buffers.erase(r.buffers.begin() + static_cast<std::ptrdiff_t>(i));
+                } else {
+                    ++i;
+                }
+            }
+        }
+
+        std::FILE* file_ = nullptr;
+        std::chrono::milliseconds flush_interval_;
+        std::thread flusher_;
+        std::atomic<bool> stop_{false};
+        double ticks_per_us_ = 1.0;
+        uint64_t base_tsc_ = 0;
+        uint32_t pid_ = 0;
+        bool first_ = true;
+        uint64_t written_ = 0;
+        std::unordered_map<uint32_t, std::string> names_;
+        std::vector<std::pair<uint32_t, std::string>> named_;
+    };
+
+} // namespace trace
+} // namespace fwilliamsca
+
+#define FWILLIAMSCA_TRACE_CONCAT_(a, b) a##b
+#define FWILLIAMSCA_TRACE_CONCAT(a, b) FWILLIAMSCA_TRACE_CONCAT_(a, b)
+
+#if defined(FWILLIAMSCA_TRACE)
+
+#define FWILLIAMSCA_TRACE_ID_(name)                                                          \
+    ([]() {                                                                                  \
+        static const uint32_t id = ::fwilliamsca::trace::register_event(name);              \
+        return id;                                                                           \
+    }())
+
+#define FWILLIAMSCA_TRACE_SCOPE(name)                                                        \
+    ::fwilliamsca::trace::Scope FWILLIAMSCA_TRACE_CONCAT(fwilliamsca_trace_scope_, __LINE__)( \
+        FWILLIAMSCA_TRACE_ID_(name))
+
+#define FWILLIAMSCA_TRACE_INSTANT(name) ::fwilliamsca::trace::instant(FWILLIAMSCA_TRACE_ID_(name))
+
+#define FWILLIAMSCA_TRACE_MARK(var) const uint64_t var = ::fwilliamsca::trace::mark()
+
+#define FWILLIAMSCA_TRACE_COMPLETE(name, var) ::fwilliamsca::trace::complete(FWILLIAMSCA_TRACE_ID_(name), var)
+
+#define FWILLIAMSCA_TRACE_COMPLETE_ID(id, var) ::fwilliamsca::trace::complete(id, var)
+
+#else
+
+#define FWILLIAMSCA_TRACE_SCOPE(name) ((void)0)
+#define FWILLIAMSCA_TRACE_INSTANT(name) ((void)0)
+#define FWILLIAMSCA_TRACE_MARK(var) ((void)0)
+#define FWILLIAMSCA_TRACE_COMPLETE(name, var) ((void)0)
+#define FWILLIAMSCA_TRACE_COMPLETE_ID(id, var) ((void)0)
+
+#endif
@@ -1,6 +1,8 @@
 /**
  * @file benchmark_main.cpp
  * @brief Benchmarking suite for SIMD kernels and Lock-Free Queue.
+ * * Every benchmark is registered with the statistical harness
+ * (bench/harness.h); run with --filter=<substr> to select a subset.
  */
 
 #include <iostream>
@@ -9,84 +11,1638 @@
 #include <thread>
 #include <random>
 #include <cstring>
+#include <array>
+#include <filesystem>
+#include <functional>
+#include <sys/epoll.h>
+#define FWILLIAMSCA_ALLOC_GUARD_HOOKS   // This binary owns the interposed allocator
+#include "../include/fwilliamsca/bench/alloc_guard.h"
+#include "../include/fwilliamsca/bench/harness.h"
+#include "../include/fwilliamsca/bench/interference.h"
+#include "../include/fwilliamsca/bench/report.h"
+#include "../include/fwilliamsca/bench/tick_to_trade.h"
+#include "../include/fwilliamsca/metrics/latency_histogram.h"
+#include "../include/fwilliamsca/concurrency/affinity.h"
+#include "../include/fwilliamsca/concurrency/topology.h"
 #include "../include/fwilliamsca/simd/intrinsics.h"
+#include "../include/fwilliamsca/simd/parallel.h"
+#include "../include/fwilliamsca/simd/vector_math.h"
+#include "../include/fwilliamsca/simd/cholesky.h"
+#include "../include/fwilliamsca/pricing/black_scholes.h"
+#include "../include/fwilliamsca/pricing/implied_vol.h"
+#include "../include/fwilliamsca/pricing/monte_carlo.h"
+#include "../include/fwilliamsca/simd/random.h"
 #include "../include/fwilliamsca/memory/ring_buffer.h"
+#include "../include/fwilliamsca/memory/notifying_ring_buffer.h"
+#include "../include/fwilliamsca/pipeline/pipeline.h"
+#include "../include/fwilliamsca/async/ring_executor.h"
+#include "../include/fwilliamsca/persistence/journal.h"
+#include "../include/fwilliamsca/trace/trace.h"
+#include "../include/fwilliamsca/timing/core_frequency.h"
 
 using namespace fwilliamsca;
 
-// RDTSC: Read Time-Stamp Counter for nanosecond precision
-inline uint64_t rdtsc() {
-    unsigned int lo, hi;
-    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
-    return ((uint64_t)hi << 32) | lo;
-}
-
-void bench_avx512_dot_product() {
-    std::cout << "[BENCH] Starting AVX-512 Dot Product Test...\n";
-    
-    constexpr size_t N = 1024 * 1024;
-    alignas(64) std::vector<double> a(N, 1.0001);
-    alignas(64) std::vector<double> b(N, 0.9999);
-
-    // Warmup
-    simd::MathKernel<>::dot_product(a.data(), b.data(), N);
-
-    auto start = std::chrono::high_resolution_clock::now();
-    uint64_t cycles_start = rdtsc();
-    
-    volatile double result = 0.0;
-    for(int i=0; i<100; ++i) {
-        result += simd::MathKernel<>::dot_product(a.data(), b.data(), N);
-    }
-
-    uint64_t cycles_end = rdtsc();
-    auto end = std::chrono::high_resolution_clock::now();
-
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    
-    std::cout << "  > Processed " << (N * 100) / 1e6 << " M elements\n";
-    std::cout << "  > Time: " << duration << " us\n";
-    std::cout << "  > Cycles per Op: " << (cycles_end - cycles_start) / (N * 100.0) << "\n";
-    std::cout << "[PASS] Result check: " << result << "\n\n";
-}
-
-void bench_ring_buffer() {
-    std::cout << "[BENCH] Starting SPSC Ring Buffer Latency Test...\n";
-    
-    memory::SPSCRingBuffer<int, 4096> ring;
-    std::atomic<bool> done{false};
-    
-    // Consumer Thread
-    std::thread consumer([&]() {
-        int val;
-        while (!done.load(std::memory_order_relaxed)) {
+// ============================================================================
+// SIMD kernels
+// ============================================================================
+
+template <simd::ISA Arch>
+void bench_dot_product(bench::State& state) {
+    if (!simd::cpu_supports(Arch)) {
+        state.skip(std::string("host lacks ") + simd::to_string(Arch));
+        return;
+    }
+    const size_t n = state.size();
+    std::vector<double> a(n, 1.0001);
+    std::vector<double> b(n, 0.9999);
+
+    double result = 0.0;
+    state.set_bytes_per_iteration(2.0 * n * sizeof(double));
+    state.set_flops_per_iteration(2.0 * n);
+    state.run([&]() {
+        result = simd::MathKernel<Arch>::dot_product(a.data(), b.data(), n);
+        bench::DoNotOptimize(result);
+    });
+
+    const double expected = 1.0001 * 0.9999 * n;
+    if (std::fabs(result - expected) > 1e-9 * expected) {
+        state.error("dot_product = " + std::to_string(result) + ", expected " + std::to_string(expected));
+    }
+}
+
+template <simd::ISA Arch>
+void bench_add(bench::State& state) {
+    if (!simd::cpu_supports(Arch)) {
+        state.skip(std::string("host lacks ") + simd::to_string(Arch));
+        return;
+    }
+    const size_t n = state.size();
+    std::vector<double> a(n, 1.5);
+    std::vector<double> b(n, 2.5);
+    std::vector<double> out(n, 0.0);
+
+    state.set_bytes_per_iteration(3.0 * n * sizeof(double));
+    state.set_flops_per_iteration(static_cast<double>(n));
+    state.run([&]() {
+        simd::MathKernel<Arch>::add(a.data(), b.data(), out.data(), n);
+        bench::ClobberMemory();
+    });
+
+    for (size_t i = 0; i < n; ++i) {
+        if (out[i] != 4.0) {
+            state.error("add mismatch at index " + std::to_string(i));
+            break;
+        }
+    }
+}
+
+// Every tier is compiled into this binary; tiers the host lacks are skipped
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_dot_product, simd::ISA::Scalar)->sizes({1 << 10, 1 << 16, 1 << 20})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_dot_product, simd::ISA::AVX2)->sizes({1 << 10, 1 << 16, 1 << 20})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_dot_product, simd::ISA::AVX512_VL)->sizes({1 << 10, 1 << 16, 1 << 20})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_dot_product, simd::ISA::AVX512_F)->sizes({1 << 10, 1 << 16, 1 << 20})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_add, simd::ISA::Scalar)->sizes({1 << 10, 1 << 16, 1 << 20})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_add, simd::ISA::AVX2)->sizes({1 << 10, 1 << 16, 1 << 20})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_add, simd::ISA::AVX512_VL)->sizes({1 << 10, 1 << 16, 1 << 20})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_add, simd::ISA::AVX512_F)->sizes({1 << 10, 1 << 16, 1 << 20})->no_alloc();
+
+/**
+ * @brief Speedup of each ISA tier over Scalar for every templated benchmark
+ * instance (names of the form fn<simd::ISA::X>/size).
+ */
+void print_isa_speedups(const std::vector<bench::Result>& results) {
+    const std::string tag = "<simd::ISA::";
+    auto split = [&](const std::string& name, std::string& base, std::string& isa) {
+        const size_t open = name.find(tag);
+        if (open == std::string::npos) return false;
+        base = name.substr(0, open);
+        isa = name.substr(open + tag.size(), name.size() - open - tag.size() - 1);
+        return true;
+    };
+
+    bool header = false;
+    for (const auto& r : results) {
+        std::string base, isa;
+        if (!split(r.name, base, isa) || isa == "Scalar" || !r.skipped.empty()) continue;
+        for (const auto& ref : results) {
+            std::string ref_base, ref_isa;
+            if (ref.size != r.size || !ref.skipped.empty() || !split(ref.name, ref_base, ref_isa)) continue;
+            if (ref_base != base || ref_isa != "Scalar" || r.ns_per_iter.median <= 0.0) continue;
+            if (!header) {
+                std::printf("\n%-28s %10s %10s %10s\n", "ISA speedup vs Scalar", "size", "ISA", "speedup");
+                header = true;
+            }
+            std::printf("%-28s %10zu %10s %9.2fx\n", base.c_str(), r.size, isa.c_str(),
+                        ref.ns_per_iter.median / r.ns_per_iter.median);
+        }
+    }
+}
+
+// ============================================================================
+// Cache-hierarchy bandwidth sweep (--sweep)
+// ============================================================================
+
+struct SweepPoint {
+    size_t footprint;   // Bytes touched per call (all operands)
+    double median_ns;
+    double gbps;
+    double gflops;
+};
+
+std::string format_bytes(size_t bytes) {
+    char buf[32];
+    if (bytes >= (size_t(1) << 30)) {
+        std::snprintf(buf, sizeof(buf), "%zu GB", bytes >> 30);
+    } else if (bytes >= (size_t(1) << 20)) {
+        std::snprintf(buf, sizeof(buf), "%zu MB", bytes >> 20);
+    } else {
+        std::snprintf(buf, sizeof(buf), "%zu KB", bytes >> 10);
+    }
+    return buf;
+}
+
+// Innermost cache level that can hold the footprint
+std::string residency(size_t footprint, const std::vector<concurrency::CacheLevel>& caches) {
+    for (const auto& c : caches) {
+        if (footprint <= c.size) return "L" + std::to_string(c.level);
+    }
+    return caches.empty() ? "?" : "DRAM";
+}
+
+/**
+ * @brief Flags points whose bandwidth is >= `drop` below the best seen since
+ * the previous transition (robust to a slow slide across two sizes).
+ */
+std::vector<double> detect_transitions(const std::vector<SweepPoint>& points, double drop = 0.2) {
+    std::vector<double> drops(points.size(), 0.0);
+    double plateau = 0.0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (plateau > 0.0 && points[i].gbps < (1.0 - drop) * plateau) {
+            drops[i] = 1.0 - points[i].gbps / plateau;
+            plateau = points[i].gbps;
+        } else {
+            plateau = std::max(plateau, points[i].gbps);
+        }
+    }
+    return drops;
+}
+
+template <typename Op>
+void sweep_operation(const std::string& label, size_t arrays, double flops_per_elem, const bench::Config& cfg,
+                     const std::vector<concurrency::CacheLevel>& caches, Op op) {
+    if (!cfg.filter.empty() && label.find(cfg.filter) == std::string::npos) return;
+    std::printf("\n[SWEEP] %s\n", label.c_str());
+    std::printf("%10s  %-5s %12s %10s %10s\n", "footprint", "fits", "median", "GB/s", "GFLOP/s");
+
+    std::vector<SweepPoint> points;
+    for (size_t footprint = size_t(1) << 10; footprint <= (size_t(1) << 30); footprint <<= 1) {
+        const size_t n = footprint / (arrays * sizeof(double));
+        std::vector<double> a(n, 1.5);
+        std::vector<double> b(n, 2.5);
+        std::vector<double> out(arrays > 2 ? n : 0);
+
+        bench::State state(cfg, n, cfg.samples);
+        state.run([&]() { op(a.data(), b.data(), out.data(), n); });
+        const bench::Summary s = bench::summarize(state.samples_ns());
+        const double bytes = static_cast<double>(n * arrays * sizeof(double));
+        points.push_back({footprint, s.median, bytes / s.median, flops_per_elem * n / s.median});
+    }
+
+    const std::vector<double> drops = detect_transitions(points);
+    for (size_t i = 0; i < points.size(); ++i) {
+        const SweepPoint& p = points[i];
+        std::printf("%10s  %-5s %12s %10.2f %10.2f", format_bytes(p.footprint).c_str(),
+                    residency(p.footprint, caches).c_str(), bench::detail::format_time(p.median_ns).c_str(),
+                    p.gbps, p.gflops);
+        if (drops[i] > 0.0) {
+            // Name the largest cache boundary already crossed
+            std::string crossed = "within " + residency(p.footprint, caches);
+            for (const auto& c : caches) {
+                if (c.size < p.footprint) crossed = "past L" + std::to_string(c.level) + " = " + format_bytes(c.size);
+            }
+            std::printf("   <-- -%.0f%% %s", 100.0 * drops[i], crossed.c_str());
+        }
+        std::printf("\n");
+    }
+
+    // Median bandwidth per residency level: the numbers used for tile sizing
+    std::printf("  plateaus:");
+    size_t i = 0;
+    while (i < points.size()) {
+        const std::string level = residency(points[i].footprint, caches);
+        std::vector<double> gbps;
+        for (; i < points.size() && residency(points[i].footprint, caches) == level; ++i) {
+            gbps.push_back(points[i].gbps);
+        }
+        std::printf("  %s %.1f GB/s", level.c_str(), bench::summarize(gbps).median);
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+template <simd::ISA Arch>
+void sweep_isa(const bench::Config& cfg, const std::vector<concurrency::CacheLevel>& caches) {
+    if (!simd::cpu_supports(Arch)) return;
+    const char* isa = simd::to_string(Arch);
+    sweep_operation(std::string("add<") + isa + ">", 3, 1.0, cfg, caches,
+                    [](const double* a, const double* b, double* out, size_t n) {
+                        simd::MathKernel<Arch>::add(a, b, out, n);
+                        bench::ClobberMemory();
+                    });
+    sweep_operation(std::string("dot_product<") + isa + ">", 2, 2.0, cfg, caches,
+                    [](const double* a, const double* b, double*, size_t n) {
+                        double r = simd::MathKernel<Arch>::dot_product(a, b, n);
+                        bench::DoNotOptimize(r);
+                    });
+}
+
+/**
+ * @brief --sweep: every MathKernel operation from 1 KB to 1 GB of operands,
+ * with cache-level transitions annotated. Uses a short per-point budget.
+ */
+int run_bandwidth_sweep(bench::Config cfg) {
+    cfg.samples = std::min<size_t>(cfg.samples, 7);
+    cfg.max_time = std::min(cfg.max_time, 0.25);
+    cfg.max_warmup_time = std::min(cfg.max_warmup_time, 0.1);
+
+    const std::vector<concurrency::CacheLevel> caches = concurrency::data_cache_levels();
+    std::printf("[SWEEP] Data caches:");
+    for (const auto& c : caches) std::printf(" L%d %s", c.level, format_bytes(c.size).c_str());
+    std::printf("\n");
+
+    sweep_isa<simd::ISA::Scalar>(cfg, caches);
+    sweep_isa<simd::ISA::AVX2>(cfg, caches);
+    sweep_isa<simd::ISA::AVX512_VL>(cfg, caches);
+    sweep_isa<simd::ISA::AVX512_F>(cfg, caches);
+    return 0;
+}
+
+// ============================================================================
+// AVX-512 frequency license (--freq)
+// ============================================================================
+
+double median_of(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+/**
+ * @brief Runs one tier's dot_product back to back for `seconds`, sampling the
+ * core clock between calls, then keeps sampling while the core idles on
+ * scalar code to show how long the license outlives the kernel.
+ */
+template <simd::ISA Arch>
+void frequency_license(double seconds) {
+    if (!simd::cpu_supports(Arch)) {
+        std::printf("%-10s SKIPPED (host lacks the ISA)\n", simd::to_string(Arch));
+        return;
+    }
+    const timing::TscClock& tsc = timing::TscClock::instance();
+    constexpr size_t N = 512;    // 8 KB of operands: L1-resident, FMA-bound
+    constexpr int CallsPerProbe = 64;
+    std::vector<double> a(N, 1.0001);
+    std::vector<double> b(N, 0.9999);
+
+    // Let any previous license expire, then sample the scalar-only clock
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::vector<double> before;
+    for (int i = 0; i < 50; ++i) before.push_back(timing::effective_core_ghz());
+
+    std::vector<double> during;
+    uint64_t calls = 0;
+    const uint64_t t_begin = timing::rdtsc();
+    const uint64_t t_end = t_begin + static_cast<uint64_t>(seconds * tsc.ghz() * 1e9);
+    while (timing::rdtsc() < t_end) {
+        for (int i = 0; i < CallsPerProbe; ++i) {
+            double r = simd::MathKernel<Arch>::dot_product(a.data(), b.data(), N);
+            bench::DoNotOptimize(r);
+        }
+        calls += CallsPerProbe;
+        during.push_back(timing::effective_core_ghz());
+    }
+    const double gflops = 2.0 * N * static_cast<double>(calls) / tsc.elapsed_ns(t_begin, timing::rdtsc());
+
+    // Recovery: probes back to back, binned by time since the last kernel call
+    constexpr double Edges_us[] = {100, 500, 1000, 2000, 5000, 10000};
+    constexpr size_t Bins = sizeof(Edges_us) / sizeof(Edges_us[0]);
+    std::vector<double> after[Bins];
+    const uint64_t t_stop = timing::rdtsc();
+    for (;;) {
+        const double ghz = timing::effective_core_ghz();
+        const double us = tsc.elapsed_ns(t_stop, timing::rdtsc()) * 1e-3;
+        size_t bin = 0;
+        while (bin < Bins && us > Edges_us[bin]) ++bin;
+        if (bin == Bins) break;
+        after[bin].push_back(ghz);
+    }
+
+    const double base = median_of(before);
+    const double hot = median_of(during);
+    std::printf("%-10s %8.2f %8.3f %8.3f %7.1f%%", simd::to_string(Arch), gflops, base, hot,
+                base > 0.0 ? 100.0 * (hot - base) / base : 0.0);
+    for (size_t i = 0; i < Bins; ++i) std::printf(" %8.3f", median_of(after[i]));
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+/**
+ * @brief --freq: effective core clock before, during and after each
+ * MathKernel tier, measured with a dependent-add chain (timing/core_frequency.h).
+ */
+int run_frequency_license(double seconds) {
+    std::printf("[FREQ] dot_product on 8 KB, %.2f s per tier; core GHz from a dependent-add chain\n", seconds);
+    std::printf("%-10s %8s %8s %8s %8s %8s %8s %8s %8s %8s %8s\n", "tier", "GFLOP/s", "idle", "during", "delta",
+                "<0.1ms", "<0.5ms", "<1ms", "<2ms", "<5ms", "<10ms");
+    frequency_license<simd::ISA::Scalar>(seconds);
+    frequency_license<simd::ISA::AVX2>(seconds);
+    frequency_license<simd::ISA::AVX512_VL>(seconds);
+    frequency_license<simd::ISA::AVX512_F>(seconds);
+    std::printf("A drop in 'during' for AVX512_F but not AVX512_VL is the 512-bit license; the\n"
+                "after-columns show how long scalar code sharing the core keeps paying for it.\n");
+    return 0;
+}
+
+void bench_parallel_dot_product(bench::State& state) {
+    const size_t n = state.size();
+    std::vector<double> a(n, 1.0001);
+    std::vector<double> b(n, 0.9999);
+    static concurrency::ThreadPool pool;
+
+    double serial = simd::MathKernel<>::dot_product(a.data(), b.data(), n);
+    double parallel = 0.0;
+    state.set_bytes_per_iteration(2.0 * n * sizeof(double));
+    state.run([&]() {
+        parallel = simd::ParallelMathKernel<>::dot_product(pool, a.data(), b.data(), n);
+        bench::DoNotOptimize(parallel);
+    });
+
+    if (std::fabs(parallel - serial) > 1e-9 * serial) {
+        state.error("parallel " + std::to_string(parallel) + " vs serial " + std::to_string(serial));
+    }
+}
+FWILLIAMSCA_BENCHMARK(bench_parallel_dot_product)->sizes({size_t(32) << 20})->samples(10);
+
+// ============================================================================
+// Vectorized transcendentals (simd/vector_math.h)
+// ============================================================================
+
+using ArrayFn = void (*)(const double*, double*, size_t);
+
+double std_norm_cdf(double x) { return 0.5 * std::erfc(-x * 0.70710678118654752); }
+
+// Extended-precision references: a double libm result can be less exact than the kernel
+long double ref_exp(long double x) { return std::exp(x); }
+long double ref_log(long double x) { return std::log(x); }
+long double ref_norm_cdf(long double x) { return 0.5L * std::erfc(-x / std::sqrt(2.0L)); }
+
+// Inputs spread over [lo, hi), fixed seed
+std::vector<double> vector_math_inputs(size_t n, double lo, double hi) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> dist(lo, hi);
+    std::vector<double> x(n);
+    for (auto& v : x) v = dist(rng);
+    return x;
+}
+
+/**
+ * @brief Times one array kernel and checks its worst relative error
+ * against a long double reference on the same inputs.
+ */
+void run_vector_math(bench::State& state, simd::ISA arch, ArrayFn fn, long double (*reference)(long double),
+                     double lo, double hi, double max_rel_error) {
+    if (!simd::cpu_supports(arch)) {
+        state.skip(std::string("host lacks ") + simd::to_string(arch));
+        return;
+    }
+    const size_t n = state.size();
+    const std::vector<double> x = vector_math_inputs(n, lo, hi);
+    std::vector<double> out(n, 0.0);
+
+    state.set_bytes_per_iteration(2.0 * n * sizeof(double));
+    state.run([&]() {
+        fn(x.data(), out.data(), n);
+        bench::ClobberMemory();
+    });
+
+    double worst = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const long double ref = reference(x[i]);
+        worst = std::max(worst, static_cast<double>(std::fabs((out[i] - ref) / ref)));
+    }
+    if (!(worst <= max_rel_error)) {
+        char msg[96];
+        std::snprintf(msg, sizeof(msg), "max relative error %.3g above %.3g", worst, max_rel_error);
+        state.error(msg);
+    }
+}
+
+// Per-element libm baseline
+void run_std_math(bench::State& state, double (*fn)(double), double lo, double hi) {
+    const size_t n = state.size();
+    const std::vector<double> x = vector_math_inputs(n, lo, hi);
+    std::vector<double> out(n, 0.0);
+    state.set_bytes_per_iteration(2.0 * n * sizeof(double));
+    state.run([&]() {
+        for (size_t i = 0; i < n; ++i) out[i] = fn(x[i]);
+        bench::ClobberMemory();
+    });
+}
+
+void bench_std_exp(bench::State& state) {
+    run_std_math(state, [](double v) { return std::exp(v); }, -50.0, 50.0);
+}
+
+void bench_std_log(bench::State& state) {
+    run_std_math(state, [](double v) { return std::log(v); }, 1e-3, 1e3);
+}
+
+void bench_std_norm_cdf(bench::State& state) {
+    run_std_math(state, std_norm_cdf, -8.0, 8.0);
+}
+
+template <simd::ISA Arch>
+void bench_vector_exp(bench::State& state) {
+    run_vector_math(state, Arch, simd::VectorMath<Arch>::exp, ref_exp, -50.0, 50.0, 4e-16);
+}
+
+template <simd::ISA Arch>
+void bench_vector_exp_fast(bench::State& state) {
+    run_vector_math(state, Arch, simd::VectorMath<Arch, simd::Accuracy::Fast>::exp,
+                    ref_exp, -50.0, 50.0, 1e-13);
+}
+
+template <simd::ISA Arch>
+void bench_vector_log(bench::State& state) {
+    run_vector_math(state, Arch, simd::VectorMath<Arch>::log, ref_log, 1e-3, 1e3, 4e-16);
+}
+
+template <simd::ISA Arch>
+void bench_vector_norm_cdf(bench::State& state) {
+    run_vector_math(state, Arch, simd::VectorMath<Arch>::norm_cdf, ref_norm_cdf, -8.0, 8.0, 2e-15);
+}
+
+template <simd::ISA Arch>
+void bench_vector_norm_cdf_fast(bench::State& state) {
+    run_vector_math(state, Arch, simd::VectorMath<Arch, simd::Accuracy::Fast>::norm_cdf, ref_norm_cdf,
+                    -8.0, 8.0, 1e-12);
+}
+
+/**
+ * @brief Log-returns over a session of prices (a random walk in ticks):
+ * bytes/iteration counts the prices read and the returns written, so
+ * GB/s compares directly with bench_add at the same footprint.
+ */
+template <simd::ISA Arch>
+void bench_log_returns(bench::State& state) {
+    if (!simd::cpu_supports(Arch)) {
+        state.skip(std::string("host lacks ") + simd::to_string(Arch));
+        return;
+    }
+    const size_t n = state.size();
+    std::vector<double> prices(n);
+    std::mt19937_64 rng(11);
+    double px = 100.0;
+    for (auto& p : prices) {
+        px += 0.01 * (static_cast<int>(rng() % 5) - 2);
+        p = px;
+    }
+    std::vector<double> out(n - 1, 0.0);
+
+    state.set_bytes_per_iteration(2.0 * n * sizeof(double));
+    state.run([&]() {
+        simd::VectorMath<Arch>::log_returns(prices.data(), out.data(), n);
+        bench::ClobberMemory();
+    });
+
+    double worst = 0.0;
+    for (size_t i = 0; i + 1 < n; ++i) {
+        const long double ref = std::log(static_cast<long double>(prices[i + 1]) / prices[i]);
+        if (ref != 0.0L) worst = std::max(worst, static_cast<double>(std::fabs((out[i] - ref) / ref)));
+        else if (out[i] != 0.0) worst = 1.0;
+    }
+    if (worst > 1e-15) {
+        char msg[64];
+        std::snprintf(msg, sizeof(msg), "max relative error %.3g", worst);
+        state.error(msg);
+    }
+}
+
+FWILLIAMSCA_BENCHMARK(bench_std_exp)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK(bench_std_log)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK(bench_std_norm_cdf)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_exp, simd::ISA::Scalar)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_exp, simd::ISA::AVX2)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_exp, simd::ISA::AVX512_VL)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_exp, simd::ISA::AVX512_F)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_exp_fast, simd::ISA::Scalar)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_exp_fast, simd::ISA::AVX512_F)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_log, simd::ISA::Scalar)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_log, simd::ISA::AVX2)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_log, simd::ISA::AVX512_VL)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_log, simd::ISA::AVX512_F)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_norm_cdf, simd::ISA::Scalar)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_norm_cdf, simd::ISA::AVX2)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_norm_cdf, simd::ISA::AVX512_VL)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_norm_cdf, simd::ISA::AVX512_F)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_norm_cdf_fast, simd::ISA::Scalar)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_vector_norm_cdf_fast, simd::ISA::AVX512_F)->sizes({1 << 12})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_log_returns, simd::ISA::Scalar)->sizes({1 << 12, 1 << 22})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_log_returns, simd::ISA::AVX2)->sizes({1 << 12, 1 << 22})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_log_returns, simd::ISA::AVX512_F)->sizes({1 << 12, 1 << 22})->no_alloc();
+
+// ============================================================================
+// Option pricing (pricing/black_scholes.h)
+// ============================================================================
+
+// A chain on one underlying: strikes within +-moneyness of spot, 1 week to 2 years, calls and puts
+struct ChainData {
+    std::vector<double> strike, expiry, vol;
+    std::vector<pricing::OptionType> type;
+    std::vector<double> price, delta, gamma, vega, theta;
+
+    explicit ChainData(size_t n, double moneyness = 0.5)
+        : strike(n), expiry(n), vol(n), type(n), price(n), delta(n), gamma(n), vega(n), theta(n) {
+        std::mt19937_64 rng(5);
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        for (size_t i = 0; i < n; ++i) {
+            strike[i] = 100.0 * (1.0 - moneyness + 2.0 * moneyness * u(rng));
+            expiry[i] = 0.02 + 2.0 * u(rng);
+            vol[i] = 0.1 + 0.5 * u(rng);
+            type[i] = (i & 1) ? pricing::OptionType::Put : pricing::OptionType::Call;
+        }
+    }
+
+    pricing::OptionChain chain() const { return {strike.data(), expiry.data(), vol.data(), type.data(), strike.size()}; }
+    pricing::GreeksOut out() { return {price.data(), delta.data(), gamma.data(), vega.data(), theta.data()}; }
+};
+
+const pricing::Market bench_market{100.0, 0.04, 0.01};
+
+void bench_black_scholes_reference(bench::State& state) {
+    ChainData data(state.size());
+    state.set_items_per_iteration(state.size());
+    state.run([&]() {
+        pricing::black_scholes_reference(bench_market, data.chain(), data.out());
+        bench::ClobberMemory();
+    });
+}
+
+/**
+ * @brief Price and four Greeks for the whole chain; items are options.
+ * Every output is checked against the scalar reference, scaled by 1 + |ref|.
+ */
+template <simd::ISA Arch, simd::Accuracy Acc>
+void bench_black_scholes(bench::State& state) {
+    if (!simd::cpu_supports(Arch)) {
+        state.skip(std::string("host lacks ") + simd::to_string(Arch));
+        return;
+    }
+    ChainData data(state.size());
+    state.set_items_per_iteration(state.size());
+    state.run([&]() {
+        pricing::BlackScholes<Arch, Acc>::price_greeks(bench_market, data.chain(), data.out());
+        bench::ClobberMemory();
+    });
+
+    ChainData ref(state.size());
+    pricing::black_scholes_reference(bench_market, ref.chain(), ref.out());
+    double worst = 0.0;
+    const std::vector<double>* outputs[] = {&data.price, &data.delta, &data.gamma, &data.vega, &data.theta};
+    const std::vector<double>* expected[] = {&ref.price, &ref.delta, &ref.gamma, &ref.vega, &ref.theta};
+    for (size_t k = 0; k < 5; ++k) {
+        for (size_t i = 0; i < state.size(); ++i) {
+            const double e = (*expected[k])[i];
+            worst = std::max(worst, std::fabs((*outputs[k])[i] - e) / (1.0 + std::fabs(e)));
+        }
+    }
+    const double bound = Acc == simd::Accuracy::Accurate ? 1e-13 : 1e-10;
+    if (!(worst <= bound)) {
+        char msg[96];
+        std::snprintf(msg, sizeof(msg), "max scaled error %.3g against the reference", worst);
+        state.error(msg);
+    }
+}
+
+FWILLIAMSCA_BENCHMARK(bench_black_scholes_reference)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_black_scholes, simd::ISA::Scalar, simd::Accuracy::Accurate)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_black_scholes, simd::ISA::AVX2, simd::Accuracy::Accurate)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_black_scholes, simd::ISA::AVX512_VL, simd::Accuracy::Accurate)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_black_scholes, simd::ISA::AVX512_F, simd::Accuracy::Accurate)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_black_scholes, simd::ISA::AVX2, simd::Accuracy::Fast)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_black_scholes, simd::ISA::AVX512_F, simd::Accuracy::Fast)->sizes({1 << 10})->no_alloc();
+
+/**
+ * @brief Implied vols of a +-30% chain priced by the reference. Warm starts
+ * from vols 1% off (a previous tick); cold from the closed-form guess.
+ * Checks the backward error: repricing at the solved vol.
+ */
+template <simd::ISA Arch, bool Warm>
+void bench_implied_vol(bench::State& state) {
+    if (!simd::cpu_supports(Arch)) {
+        state.skip(std::string("host lacks ") + simd::to_string(Arch));
+        return;
+    }
+    const size_t n = state.size();
+    ChainData data(n, 0.3);
+    pricing::black_scholes_reference(bench_market, data.chain(), data.out());
+    std::vector<double> guess(n), solved(n);
+    for (size_t i = 0; i < n; ++i) guess[i] = data.vol[i] * (i % 3 == 0 ? 1.01 : 0.99);
+    pricing::OptionChain chain = data.chain();
+    chain.vol = Warm ? guess.data() : nullptr;
+
+    size_t iterations = 0;
+    size_t failed = pricing::ImpliedVol<Arch>::solve(bench_market, chain, data.price.data(), solved.data(), {},
+                                                      &iterations);
+    state.set_items_per_iteration(n);
+    state.run([&]() {
+        pricing::ImpliedVol<Arch>::solve(bench_market, chain, data.price.data(), solved.data());
+        bench::ClobberMemory();
+    });
+
+    double worst = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double repriced = pricing::black_scholes_reference(bench_market, data.strike[i], data.expiry[i],
+                                                                 solved[i], data.type[i]).price;
+        worst = std::max(worst, std::fabs(repriced - data.price[i]));
+    }
+    if (failed != 0 || !(worst <= 1e-12)) {
+        const size_t registers = (n + pricing::ImpliedVol<Arch>::Width - 1) / pricing::ImpliedVol<Arch>::Width;
+        char msg[128];
+        std::snprintf(msg, sizeof(msg), "%zu failed, max repricing error %.3g, %.2f iterations/register", failed,
+                      worst, static_cast<double>(iterations) / registers);
+        state.error(msg);
+    }
+}
+
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_implied_vol, simd::ISA::Scalar, false)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_implied_vol, simd::ISA::AVX2, false)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_implied_vol, simd::ISA::AVX512_F, false)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_implied_vol, simd::ISA::Scalar, true)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_implied_vol, simd::ISA::AVX2, true)->sizes({1 << 10})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_implied_vol, simd::ISA::AVX512_F, true)->sizes({1 << 10})->no_alloc();
+
+// ============================================================================
+// Monte Carlo (simd/random.h, pricing/monte_carlo.h)
+// ============================================================================
+
+// Baseline: the generator the risk engine draws from one value at a time
+void bench_std_normal(bench::State& state) {
+    const size_t n = state.size();
+    std::vector<double> out(n);
+    std::mt19937_64 gen(42);
+    std::normal_distribution<double> dist;
+    state.set_items_per_iteration(n);
+    state.run([&]() {
+        for (size_t i = 0; i < n; ++i) out[i] = dist(gen);
+        bench::ClobberMemory();
+    });
+}
+
+/**
+ * @brief Philox known-answer vectors (Random123 kat_vectors), then a
+ * tier's output against the Scalar tier for the same stream.
+ */
+template <simd::ISA Arch, bool Normal>
+void bench_philox(bench::State& state) {
+    if (!simd::cpu_supports(Arch)) {
+        state.skip(std::string("host lacks ") + simd::to_string(Arch));
+        return;
+    }
+    const std::array<uint32_t, 4> zero = simd::philox4x32_10({0, 0, 0, 0}, 0);
+    const std::array<uint32_t, 4> ones = simd::philox4x32_10({~0u, ~0u, ~0u, ~0u}, ~uint64_t(0));
+    if (zero != std::array<uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8} ||
+        ones != std::array<uint32_t, 4>{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}) {
+        state.error("Philox4x32-10 known-answer test failed");
+        return;
+    }
+
+    const size_t n = state.size();
+    std::vector<double> out(n), ref(n);
+    simd::Philox<Arch> rng(42, 7);
+    state.set_items_per_iteration(n);
+    state.run([&]() {
+        if constexpr (Normal) rng.normal(out.data(), n);
+        else rng.uniform(out.data(), n);
+        bench::ClobberMemory();
+    });
+
+    // Same blocks on both tiers; only FMA contraction may differ
+    rng.seek(0);
+    simd::Philox<simd::ISA::Scalar> scalar(42, 7);
+    if constexpr (Normal) {
+        rng.normal(out.data(), n);
+        scalar.normal(ref.data(), n);
+    } else {
+        rng.uniform(out.data(), n);
+        scalar.uniform(ref.data(), n);
+    }
+    double worst = 0.0;
+    for (size_t i = 0; i < n; ++i) worst = std::max(worst, std::fabs(out[i] - ref[i]));
+    if (!(worst <= 1e-12)) {
+        char msg[96];
+        std::snprintf(msg, sizeof(msg), "max difference %.3g from the Scalar tier", worst);
+        state.error(msg);
+    }
+}
+
+FWILLIAMSCA_BENCHMARK(bench_std_normal)->sizes({1 << 16})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_philox, simd::ISA::Scalar, true)->sizes({1 << 16})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_philox, simd::ISA::AVX2, true)->sizes({1 << 16})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_philox, simd::ISA::AVX512_F, true)->sizes({1 << 16})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_philox, simd::ISA::AVX2, false)->sizes({1 << 16})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_philox, simd::ISA::AVX512_F, false)->sizes({1 << 16})->no_alloc();
+
+/**
+ * @brief One year of daily steps for two assets at correlation 0.6; items
+ * are path-steps. Checks the terminal means against S0 e^{mu T} and the
+ * pool overload against the serial one (bitwise).
+ */
+template <simd::ISA Arch>
+void bench_gbm_paths(bench::State& state) {
+    if (!simd::cpu_supports(Arch)) {
+        state.skip(std::string("host lacks ") + simd::to_string(Arch));
+        return;
+    }
+    constexpr size_t steps = 252;
+    const size_t paths = state.size();
+    const double rho = 0.6;
+    const std::vector<pricing::GbmAsset> assets = {{100.0, 0.03, 0.2}, {50.0, 0.01, 0.3}};
+    const pricing::GbmPathEngine<Arch> engine(assets, 1.0 / steps, 42, {1.0, 0.0, rho, std::sqrt(1.0 - rho * rho)});
+    std::vector<double> out(steps * assets.size() * paths);
+
+    engine.simulate(0, paths, steps, out.data());
+    state.set_items_per_iteration(static_cast<double>(paths) * steps);
+    state.run([&]() {
+        engine.simulate(0, paths, steps, out.data());
+        bench::ClobberMemory();
+    });
+
+    for (size_t a = 0; a < assets.size(); ++a) {
+        const double* terminal = out.data() + ((steps - 1) * assets.size() + a) * paths;
+        double sum = 0.0, sum_sq = 0.0;
+        for (size_t p = 0; p < paths; ++p) {
+            sum += terminal[p];
+            sum_sq += terminal[p] * terminal[p];
+        }
+        const double mean = sum / paths;
+        const double std_error = std::sqrt((sum_sq / paths - mean * mean) / paths);
+        const double expected = assets[a].spot * std::exp(assets[a].drift);
+        if (!(std::fabs(mean - expected) <= 5.0 * std_error)) {
+            char msg[128];
+            std::snprintf(msg, sizeof(msg), "asset %zu terminal mean %.4f, expected %.4f +- %.4f", a, mean, expected,
+                          std_error);
+            state.error(msg);
+            return;
+        }
+    }
+
+    static concurrency::ThreadPool pool;
+    std::vector<double> parallel(out.size());
+    engine.simulate(pool, 0, paths, steps, parallel.data());
+    if (std::memcmp(parallel.data(), out.data(), out.size() * sizeof(double)) != 0) {
+        state.error("pool result differs from the serial result");
+    }
+}
+
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_gbm_paths, simd::ISA::Scalar)->sizes({1 << 13})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_gbm_paths, simd::ISA::AVX2)->sizes({1 << 13})->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_gbm_paths, simd::ISA::AVX512_F)->sizes({1 << 13})->no_alloc();
+
+// ============================================================================
+// Linear algebra (simd/cholesky.h)
+// ============================================================================
+
+// Dense positive-definite correlation-like matrix: 0.7 I + 0.3 * ones + 0.1 cos(i - j)
+template <class T>
+std::vector<T> correlation_matrix(size_t n) {
+    std::vector<T> a(n * n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            a[i * n + j] = static_cast<T>(0.3 + 0.1 * std::cos(static_cast<double>(i) - static_cast<double>(j)) +
+                                          (i == j ? 0.7 : 0.0));
+        }
+    }
+    return a;
+}
+
+// Worst |(L L^T)_ij - A_ij| over a fixed sample of lower-triangle entries
+template <class T>
+double cholesky_residual(const std::vector<T>& l, const std::vector<T>& a, size_t n) {
+    std::mt19937_64 gen(7);
+    double worst = 0.0;
+    for (int s = 0; s < 2000; ++s) {
+        size_t i = gen() % n, j = gen() % n;
+        if (j > i) std::swap(i, j);
+        double sum = 0.0;
+        for (size_t k = 0; k <= j; ++k) sum += static_cast<double>(l[i * n + k]) * l[j * n + k];
+        worst = std::max(worst, std::fabs(sum - a[i * n + j]));
+    }
+    return worst;
+}
+
+void bench_cholesky_reference(bench::State& state) {
+    const size_t n = state.size();
+    const std::vector<double> a = correlation_matrix<double>(n);
+    std::vector<double> l(n * n);
+    state.set_items_per_iteration(static_cast<double>(n) * n * n / 3);
+    state.run([&]() {
+        std::memcpy(l.data(), a.data(), n * n * sizeof(double));
+        bench::DoNotOptimize(simd::cholesky_reference(l.data(), n, n));
+        bench::ClobberMemory();
+    });
+}
+
+/**
+ * @brief In-place factorization including the copy of A; items are flops
+ * (n^3 / 3). Checks a sample of L L^T against A.
+ */
+template <simd::ISA Arch, class T>
+void bench_cholesky(bench::State& state) {
+    if (!simd::cpu_supports(Arch)) {
+        state.skip(std::string("host lacks ") + simd::to_string(Arch));
+        return;
+    }
+    const size_t n = state.size();
+    const std::vector<T> a = correlation_matrix<T>(n);
+    std::vector<T> l(n * n);
+    bool ok = true;
+    state.set_items_per_iteration(static_cast<double>(n) * n * n / 3);
+    state.run([&]() {
+        std::memcpy(l.data(), a.data(), n * n * sizeof(T));
+        ok = simd::Cholesky<Arch>::factor(l.data(), n);
+        bench::ClobberMemory();
+    });
+
+    const double residual = cholesky_residual(l, a, n);
+    const double bound = 8.0 * n * std::numeric_limits<T>::epsilon();
+    if (!ok || !(residual <= bound)) {
+        char msg[96];
+        std::snprintf(msg, sizeof(msg), "factor %s, max residual %.3g (bound %.3g)", ok ? "ok" : "failed", residual,
+                      bound);
+        state.error(msg);
+    }
+}
+
+/**
+ * @brief z = L x for a batch of 256 draws; items are flops (n^2 per draw).
+ * Checks the first draws against the scalar reference.
+ */
+template <simd::ISA Arch, class T>
+void bench_lower_multiply(bench::State& state) {
+    if (!simd::cpu_supports(Arch)) {
+        state.skip(std::string("host lacks ") + simd::to_string(Arch));
+        return;
+    }
+    constexpr size_t batch = 256;
+    const size_t n = state.size();
+    std::vector<T> l = correlation_matrix<T>(n);
+    simd::Cholesky<Arch>::factor(l.data(), n);
+    std::vector<T> x(batch * n), z(batch * n), ref(4 * n);
+    simd::Philox<simd::ISA::Scalar> rng(3, 0);
+    std::vector<double> eps(batch * n);
+    rng.normal(eps.data(), eps.size());
+    for (size_t i = 0; i < x.size(); ++i) x[i] = static_cast<T>(eps[i]);
+
+    state.set_items_per_iteration(static_cast<double>(n) * n * batch);
+    state.run([&]() {
+        simd::Cholesky<Arch>::lower_multiply(l.data(), n, x.data(), z.data(), batch);
+        bench::ClobberMemory();
+    });
+
+    simd::lower_multiply_reference(l.data(), n, x.data(), ref.data(), 4);
+    double worst = 0.0;
+    for (size_t i = 0; i < ref.size(); ++i) worst = std::max(worst, static_cast<double>(std::fabs(z[i] - ref[i])));
+    const double bound = 4.0 * std::sqrt(static_cast<double>(n)) * std::numeric_limits<T>::epsilon();
+    if (!(worst <= bound)) {
+        char msg[96];
+        std::snprintf(msg, sizeof(msg), "max difference %.3g from the reference (bound %.3g)", worst, bound);
+        state.error(msg);
+    }
+}
+
+FWILLIAMSCA_BENCHMARK(bench_cholesky_reference)->sizes({64, 512})->samples(10)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_cholesky, simd::ISA::Scalar, double)->sizes({64, 512})->samples(10)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_cholesky, simd::ISA::AVX2, double)->sizes({64, 512, 2000})->samples(10)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_cholesky, simd::ISA::AVX512_VL, double)->sizes({64, 512, 2000})->samples(10)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_cholesky, simd::ISA::AVX512_F, double)->sizes({64, 512, 2000})->samples(10)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_cholesky, simd::ISA::AVX2, float)->sizes({64, 512, 2000})->samples(10)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_cholesky, simd::ISA::AVX512_F, float)->sizes({64, 512, 2000})->samples(10)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_lower_multiply, simd::ISA::Scalar, double)->sizes({512})->samples(10)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_lower_multiply, simd::ISA::AVX2, double)->sizes({512})->samples(10)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_lower_multiply, simd::ISA::AVX512_F, double)->sizes({512})->samples(10)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_lower_multiply, simd::ISA::AVX512_F, float)->sizes({512})->samples(10)->no_alloc();
+
+// ============================================================================
+// Metrics
+// ============================================================================
+
+void bench_histogram_record(bench::State& state) {
+    metrics::LatencyHistogram<> hist;
+    std::mt19937_64 rng(42);
+    std::lognormal_distribution<double> dist(5.0, 1.0);
+    std::vector<uint64_t> values(4096);
+    for (auto& v : values) v = static_cast<uint64_t>(dist(rng));
+
+    size_t i = 0;
+    state.set_items_per_iteration(1);
+    state.run([&]() {
+        hist.record(values[i++ & (values.size() - 1)]);
+    });
+
+    // Round-trip the binary dump and check a percentile survives it
+    metrics::LatencyHistogram<> copy;
+    if (!copy.deserialize(hist.serialize()) || copy.value_at_percentile(99.0) != hist.value_at_percentile(99.0)) {
+        state.error("histogram serialize/deserialize mismatch");
+    }
+}
+FWILLIAMSCA_BENCHMARK(bench_histogram_record)->no_alloc();
+
+void bench_trace_scope(bench::State& state) {
+#if defined(FWILLIAMSCA_TRACE)
+    // Reuse a --trace session if one is running, else record into a scratch file
+    std::unique_ptr<trace::TraceSession> session;
+    if (!trace::enabled()) {
+        session = std::make_unique<trace::TraceSession>(
+            (std::filesystem::temp_directory_path() / "fwilliamsca_bench_trace.json").string());
+    }
+    trace::set_thread_name("bench");
+    state.set_items_per_iteration(1);
+    state.run([&]() {
+        FWILLIAMSCA_TRACE_SCOPE("bench.trace_scope");
+        bench::ClobberMemory();
+    });
+    if (session) {
+        session->stop();
+        std::filesystem::remove(std::filesystem::temp_directory_path() / "fwilliamsca_bench_trace.json");
+    }
+#else
+    state.skip("built without -DFWILLIAMSCA_TRACE");
+#endif
+}
+FWILLIAMSCA_BENCHMARK(bench_trace_scope)->no_alloc();
+
+// ============================================================================
+// Queues
+// ============================================================================
+
+template <typename Telemetry>
+void bench_ring_buffer(bench::State& state) {
+    constexpr int N = 1000000;
+    memory::SPSCRingBuffer<int, 4096, Telemetry> ring;
+
+    state.set_items_per_iteration(N);
+    state.run([&]() {
+        std::atomic<bool> done{false};
+
+        // Consumer Thread
+        std::thread consumer([&]() {
+            int val;
+            while (!done.load(std::memory_order_relaxed)) {
+                while (ring.try_pop(val)) {
+                    // consume
+                    __asm__ volatile("" ::: "memory");
+                }
+                std::this_thread::yield();
+            }
             while (ring.try_pop(val)) {
-                // consume
-                __asm__ volatile("" ::: "memory");
             }
+        });
+
+        // Producer Loop
+        for (int i = 0; i < N; ++i) {
+            while (!ring.try_push(i)) {
+                _mm_pause(); // Intel pause instruction
+            }
+        }
+
+        done.store(true);
+        consumer.join();
+    });
+
+    if constexpr (std::is_same_v<Telemetry, memory::RingTelemetry>) {
+        const memory::RingTelemetrySnapshot t = ring.telemetry();
+        uint64_t sampled = 0;
+        for (uint64_t c : t.occupancy) sampled += c;
+        if (t.pushes != t.pops || t.pushes % N != 0 || sampled != t.pushes || t.high_water >= 4096) {
+            state.error("telemetry: pushes " + std::to_string(t.pushes) + " pops " + std::to_string(t.pops) +
+                        " high water " + std::to_string(t.high_water));
+        }
+    }
+}
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_ring_buffer, memory::NoRingTelemetry)->samples(10);
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_ring_buffer, memory::RingTelemetry)->samples(10);
+
+/**
+ * @brief One thread pushes and pops (single and bulk): the ring's own cost
+ * with no cross-core traffic, and the paths --alloc-check holds to zero.
+ */
+template <typename Telemetry>
+void bench_ring_push_pop(bench::State& state) {
+    memory::SPSCRingBuffer<uint64_t, 1024, Telemetry> ring;
+    std::array<uint64_t, 16> batch{};
+    uint64_t v = 0;
+
+    state.set_items_per_iteration(1 + batch.size());
+    state.run([&]() {
+        ring.try_push(v);
+        ring.try_pop(v);
+        ring.try_push_bulk(batch.data(), batch.size());
+        ring.try_pop_bulk(batch.data(), batch.size());
+        bench::DoNotOptimize(v);
+    });
+}
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_ring_push_pop, memory::NoRingTelemetry)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_ring_push_pop, memory::RingLatencyTelemetry<16>)->no_alloc();
+FWILLIAMSCA_BENCHMARK_TEMPLATE(bench_ring_push_pop, memory::RingLatencyTelemetry<1024>)->no_alloc();
+
+/**
+ * @brief Queueing delay inside the ring (push stamp -> pop), every 16th message.
+ */
+void bench_ring_queueing_latency(bench::State& state) {
+    constexpr int N = 200000;
+    constexpr size_t SampleEvery = 16;
+    using Ring = memory::SPSCRingBuffer<int, 1024, memory::RingLatencyTelemetry<SampleEvery>>;
+    const double ns_per_tick = 1.0 / timing::TscClock::instance().ticks_per_ns();
+
+    state.set_items_per_iteration(N);
+    state.run([&]() {
+        // Fresh ring per op so each histogram covers exactly one run
+        Ring ring;
+        std::thread consumer([&]() {
+            int val;
+            for (int received = 0; received < N;) {
+                if (ring.try_pop(val)) {
+                    ++received;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        for (int i = 0; i < N; ++i) {
+            while (!ring.try_push(i)) {
+                _mm_pause();
+            }
+        }
+        consumer.join();
+
+        const metrics::LatencyHistogram<>& ticks = ring.latency();
+        state.record_latency_ticks(ticks, ns_per_tick);
+        if (ticks.count() != ring.telemetry().pops / SampleEvery) {
+            state.error("sampled " + std::to_string(ticks.count()) + " of " + std::to_string(ring.telemetry().pops));
+        }
+    });
+}
+FWILLIAMSCA_BENCHMARK(bench_ring_queueing_latency)->samples(5);
+
+/**
+ * @brief Ping-pong between two threads over a pair of rings. Records each
+ * round trip (TSC ticks) into hist. cpu_a/cpu_b of -1 leave a side unpinned.
+ */
+void ring_ping_pong(int cpu_a, int cpu_b, size_t rounds, metrics::LatencyHistogram<>& hist) {
+    constexpr size_t Warmup = 1000;
+    memory::SPSCRingBuffer<uint64_t, 64> ping;
+    memory::SPSCRingBuffer<uint64_t, 64> pong;
+
+    std::thread echo([&]() {
+        if (cpu_b >= 0) concurrency::pin_current_thread(cpu_b);
+        uint64_t v;
+        for (size_t i = 0; i < Warmup + rounds; ++i) {
+            while (!ping.try_pop(v)) _mm_pause();
+            while (!pong.try_push(v)) _mm_pause();
+        }
+    });
+
+    std::thread measure([&]() {
+        if (cpu_a >= 0) concurrency::pin_current_thread(cpu_a);
+        uint64_t v;
+        for (size_t i = 0; i < Warmup + rounds; ++i) {
+            const uint64_t t0 = timing::rdtsc_start();
+            while (!ping.try_push(i)) _mm_pause();
+            while (!pong.try_pop(v)) _mm_pause();
+            const uint64_t t1 = timing::rdtsc_stop();
+            if (i >= Warmup) hist.record(t1 - t0);
+        }
+    });
+
+    measure.join();
+    echo.join();
+}
+
+void bench_ring_round_trip(bench::State& state) {
+    const concurrency::CpuTopology topo = concurrency::CpuTopology::detect();
+    if (topo.size() < 2) {
+        state.skip("needs two CPUs in the affinity mask");
+        return;
+    }
+    constexpr size_t Rounds = 10000;
+    const int a = topo.cpus()[0].cpu;
+    const int b = topo.cpus()[1].cpu;
+    const double ns_per_tick = 1.0 / timing::TscClock::instance().ticks_per_ns();
+
+    state.set_items_per_iteration(Rounds);
+    state.run([&]() {
+        metrics::LatencyHistogram<> ticks;
+        ring_ping_pong(a, b, Rounds, ticks);
+        state.record_latency_ticks(ticks, ns_per_tick);
+    });
+}
+FWILLIAMSCA_BENCHMARK(bench_ring_round_trip)->samples(10);
+
+/**
+ * @brief --c2c: round-trip latency for every ordered CPU pair, as a matrix
+ * of median ns, plus p50/p99 per topology relation.
+ */
+int run_c2c_matrix(size_t rounds) {
+    const concurrency::CpuTopology topo = concurrency::CpuTopology::detect();
+    const auto& cpus = topo.cpus();
+    if (cpus.size() < 2) {
+        std::printf("[C2C] Needs at least two CPUs in the affinity mask (have %zu).\n", cpus.size());
+        return 0;
+    }
+    const timing::TscClock& tsc = timing::TscClock::instance();
+    const double ns_per_tick = 1.0 / tsc.ticks_per_ns();
+
+    constexpr size_t Relations = 6;
+    metrics::LatencyHistogram<> by_relation[Relations];
+
+    std::printf("[C2C] SPSC ring round-trip median (ns), %zu round trips per pair\n", rounds);
+    std::printf("%6s", "");
+    for (const auto& c : cpus) std::printf("%7d", c.cpu);
+    std::printf("\n");
+    for (const auto& row : cpus) {
+        std::printf("%6d", row.cpu);
+        for (const auto& col : cpus) {
+            if (row.cpu == col.cpu) {
+                std::printf("%7s", "-");
+                continue;
+            }
+            metrics::LatencyHistogram<> hist;
+            ring_ping_pong(row.cpu, col.cpu, rounds, hist);
+            by_relation[static_cast<size_t>(topo.relation(row.cpu, col.cpu))].merge(hist);
+            std::printf("%7.0f", hist.value_at_percentile(50.0) * ns_per_tick);
+            std::fflush(stdout);
+        }
+        std::printf("\n");
+    }
+
+    std::printf("\n[C2C] By topology relation:\n");
+    for (size_t r = 1; r < Relations; ++r) {
+        if (by_relation[r].count() == 0) continue;
+        std::printf("  %-7s ", concurrency::to_string(static_cast<concurrency::CpuRelation>(r)));
+        by_relation[r].print(stdout, "ns", ns_per_tick);
+    }
+    return 0;
+}
+
+// ============================================================================
+// Tail latency under interference (--jitter)
+// ============================================================================
+
+struct JitterProbe {
+    std::string name;
+    bool needs_pair;   // Uses the second probe CPU
+    // Records per-operation latency (TSC ticks) until the deadline
+    std::function<void(int, int, uint64_t, metrics::LatencyHistogram<>&)> run;
+};
+
+template <typename Op>
+void time_until(uint64_t deadline, metrics::LatencyHistogram<>& hist, Op op) {
+    while (timing::rdtsc() < deadline) {
+        const uint64_t t0 = timing::rdtsc_start();
+        op();
+        const uint64_t t1 = timing::rdtsc_stop();
+        hist.record(t1 - t0);
+    }
+}
+
+std::vector<JitterProbe> jitter_probes() {
+    std::vector<JitterProbe> probes;
+    for (size_t bytes : {size_t(4) << 10, size_t(1) << 20}) {
+        probes.push_back({std::string("dot_product<") + simd::to_string(simd::CurrentArch) + "> " + format_bytes(bytes),
+                          false, [bytes](int cpu, int, uint64_t deadline, metrics::LatencyHistogram<>& hist) {
+                              if (cpu >= 0) concurrency::pin_current_thread(cpu);
+                              const size_t n = bytes / (2 * sizeof(double));
+                              std::vector<double> a(n, 1.0001);
+                              std::vector<double> b(n, 0.9999);
+                              time_until(deadline, hist, [&]() {
+                                  double r = simd::MathKernel<simd::CurrentArch>::dot_product(a.data(), b.data(), n);
+                                  bench::DoNotOptimize(r);
+                              });
+                          }});
+    }
+    probes.push_back({"ring push+pop (one thread)", false,
+                      [](int cpu, int, uint64_t deadline, metrics::LatencyHistogram<>& hist) {
+                          if (cpu >= 0) concurrency::pin_current_thread(cpu);
+                          memory::SPSCRingBuffer<uint64_t, 1024> ring;
+                          uint64_t v = 0;
+                          time_until(deadline, hist, [&]() {
+                              ring.try_push(v);
+                              ring.try_pop(v);
+                              bench::DoNotOptimize(v);
+                          });
+                      }});
+    probes.push_back({"ring round trip (two threads)", true,
+                      [](int cpu_a, int cpu_b, uint64_t deadline, metrics::LatencyHistogram<>& hist) {
+                          while (timing::rdtsc() < deadline) ring_ping_pong(cpu_a, cpu_b, 10000, hist);
+                      }});
+    return probes;
+}
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        const size_t comma = std::min(list.find(',', pos), list.size());
+        const std::string item = list.substr(pos, comma - pos);
+        const size_t dash = item.find('-');
+        if (dash == std::string::npos) {
+            cpus.push_back(std::stoi(item));
+        } else {
+            for (int c = std::stoi(item.substr(0, dash)); c <= std::stoi(item.substr(dash + 1)); ++c) cpus.push_back(c);
+        }
+        pos = comma + 1;
+    }
+    return cpus;
+}
+
+struct JitterConfig {
+    std::vector<bench::Interferer> interferers = {bench::Interferer::None, bench::Interferer::MemoryBandwidth,
+                                                  bench::Interferer::LlcThrasher, bench::Interferer::Avx512,
+                                                  bench::Interferer::SyscallStorm};
+    std::vector<int> noise_cpus;   // Empty: every CPU not used by the probe
+    double seconds = 1.0;          // Per probe and interferer
+};
+
+/**
+ * @brief --jitter: each probe's latency distribution with every interferer
+ * running on the other CPUs, and the p99.99 shift relative to no load.
+ */
+int run_jitter(const bench::Config& cfg, const JitterConfig& jc) {
+    const concurrency::CpuTopology topo = concurrency::CpuTopology::detect();
+    const auto& cpus = topo.cpus();
+    const int probe_a = cpus.empty() ? -1 : cpus[0].cpu;
+    const int probe_b = cpus.size() > 1 ? cpus[1].cpu : -1;
+    const timing::TscClock& tsc = timing::TscClock::instance();
+    const double ns_per_tick = 1.0 / tsc.ticks_per_ns();
+
+    for (const JitterProbe& probe : jitter_probes()) {
+        if (!cfg.filter.empty() && probe.name.find(cfg.filter) == std::string::npos) continue;
+        if (probe.needs_pair && probe_b < 0) {
+            std::printf("\n[JITTER] %s: SKIPPED (needs two CPUs in the affinity mask)\n", probe.name.c_str());
+            continue;
+        }
+
+        std::vector<int> noise = jc.noise_cpus;
+        if (noise.empty()) {
+            for (const auto& c : cpus) {
+                if (c.cpu != probe_a && !(probe.needs_pair && c.cpu == probe_b)) noise.push_back(c.cpu);
+            }
+        }
+        std::printf("\n[JITTER] %s, probe cpu %d", probe.name.c_str(), probe_a);
+        if (probe.needs_pair) std::printf("+%d", probe_b);
+        if (noise.empty()) {
+            // Interferers then time-share the probe's core: the shift measures preemption, not contention
+            noise.push_back(-1);
+            std::printf(", noise unpinned (WARNING: no spare CPU, interferers share the probe's core)\n");
+        } else {
+            std::printf(", noise cpus");
+            for (int c : noise) std::printf(" %d", c);
+            std::printf("\n");
+        }
+        std::printf("  %-11s %10s %9s %9s %9s %9s %9s %10s\n", "interferer", "samples", "p50", "p99", "p99.9",
+                    "p99.99", "max", "p99.99 x");
+
+        double baseline = 0.0;
+        for (bench::Interferer kind : jc.interferers) {
+            if (!bench::interferer_supported(kind)) {
+                std::printf("  %-11s SKIPPED (host lacks the ISA)\n", bench::to_string(kind));
+                continue;
+            }
+            metrics::LatencyHistogram<> hist;
+            {
+                bench::InterferenceGroup group(kind, noise);
+                // Let the interferers ramp up (fill their buffers, reach steady frequency)
+                std::this_thread::sleep_for(std::chrono::milliseconds(kind == bench::Interferer::None ? 0 : 200));
+                const uint64_t deadline = timing::rdtsc() + static_cast<uint64_t>(jc.seconds * tsc.ghz() * 1e9);
+                std::thread runner([&]() { probe.run(probe_a, probe_b, deadline, hist); });
+                runner.join();
+            }
+            const double tail = hist.value_at_percentile(99.99) * ns_per_tick;
+            if (kind == bench::Interferer::None) baseline = tail;
+            std::printf("  %-11s %10llu %9.0f %9.0f %9.0f %9.0f %9.0f", bench::to_string(kind),
+                        static_cast<unsigned long long>(hist.count()), hist.value_at_percentile(50.0) * ns_per_tick,
+                        hist.value_at_percentile(99.0) * ns_per_tick, hist.value_at_percentile(99.9) * ns_per_tick,
+                        tail, hist.max() * ns_per_tick);
+            if (baseline > 0.0) {
+                std::printf(" %9.2fx\n", tail / baseline);
+            } else {
+                std::printf(" %10s\n", "-");
+            }
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}
+
+void bench_notifying_ring(bench::State& state) {
+    constexpr int Bursts = 20;
+    constexpr int BurstSize = 1000;
+    memory::NotifyingSPSCRingBuffer<int, 4096> ring;
+
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = ring.fd();
+    epoll_ctl(ep, EPOLL_CTL_ADD, ring.fd(), &ev);
+
+    long received = 0;
+    state.set_items_per_iteration(Bursts * BurstSize);
+    state.run([&]() {
+        received = 0;
+        std::thread consumer([&]() {
+            epoll_event events[4];
+            int val;
+            for (;;) {
+                while (ring.try_pop(val)) ++received;
+                // Nothing will signal after the last message: never arm a wait for it
+                if (received == static_cast<long>(Bursts) * BurstSize) break;
+                if (ring.prepare_wait()) {
+                    epoll_wait(ep, events, 4, 1000);
+                }
+                ring.finish_wait();
+            }
+        });
+
+        // Bursty producer: the consumer sleeps in epoll_wait between bursts
+        for (int b = 0; b < Bursts; ++b) {
+            for (int i = 0; i < BurstSize; ++i) {
+                while (!ring.try_push(i)) _mm_pause();
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        consumer.join();
+    });
+    close(ep);
+
+    if (received != static_cast<long>(Bursts) * BurstSize) {
+        state.error("received " + std::to_string(received) + " messages");
+    }
+}
+FWILLIAMSCA_BENCHMARK(bench_notifying_ring)->samples(5);
+
+void bench_pipeline(bench::State& state) {
+    constexpr long N = 1000000;
+    memory::SPSCRingBuffer<long, 4096> raw;
+    memory::SPSCRingBuffer<long, 4096> signals;
+    const pipeline::StageConfig cfg{-1, pipeline::BackPressure::Yield, 64};
+
+    long checksum = 0;
+    state.set_items_per_iteration(N);
+    state.run([&]() {
+        long next = 0;
+        checksum = 0;
+
+        pipeline::Pipeline<> pipe;
+        pipe.add_source("feed", raw, [&](long& out) {
+            if (next == N) return false;
+            out = next++;
+            return true;
+        }, cfg);
+        pipe.add_stage("decode+signal", raw, signals, pipeline::fuse(
+            [](long& in, double& px) { px = in * 0.5; return true; },
+            [](double& px, long& out) { out = static_cast<long>(px * 2.0); return true; }), cfg);
+        pipe.add_sink("risk", signals, [&](long& v) { checksum += v; }, cfg);
+
+        pipe.start();
+        while (pipe.stats(0).messages_in != static_cast<uint64_t>(N)) {
             std::this_thread::yield();
         }
+        pipe.stop();
+    });
+
+    if (checksum != (N - 1) * N / 2) {
+        state.error("checksum " + std::to_string(checksum));
+    }
+}
+FWILLIAMSCA_BENCHMARK(bench_pipeline)->samples(5);
+
+// ============================================================================
+// End-to-end tick-to-trade (bench/tick_to_trade.h)
+// ============================================================================
+
+// One CPU per stage when the mask has enough, else every stage unpinned
+bench::TickToTradeConfig tick_to_trade_config() {
+    bench::TickToTradeConfig cfg;
+    const concurrency::CpuTopology topo = concurrency::CpuTopology::detect();
+    if (topo.size() >= 6) {
+        for (size_t i = 0; i < 6; ++i) cfg.cores.push_back(topo.cpus()[i].cpu);
+    } else {
+        cfg.idle_spins = 64;
+    }
+    return cfg;
+}
+
+std::string check_tick_to_trade(const bench::TickToTradeReport& r, size_t packets) {
+    if (r.stages.front().second.messages_in != packets) return "feed sent " + std::to_string(r.stages.front().second.messages_in);
+    if (r.seq_gaps != 0 || r.malformed != 0) {
+        return std::to_string(r.seq_gaps) + " sequence gaps, " + std::to_string(r.malformed) + " malformed";
+    }
+    const uint64_t sent = r.stages[4].second.messages_out;
+    if (r.exchange.orders != sent || r.exchange.fills + r.exchange.misses != sent) {
+        return "exchange saw " + std::to_string(r.exchange.orders) + " of " + std::to_string(sent) + " orders";
+    }
+    return "";
+}
+
+/**
+ * @brief Wire-to-wire latency of the reference path: feed emit to order
+ * arrival at the simulated exchange, at 1M packets/s.
+ */
+void bench_tick_to_trade(bench::State& state) {
+    bench::TickToTradeConfig cfg = tick_to_trade_config();
+    cfg.packets = 100000;
+    const double ns_per_tick = 1.0 / timing::TscClock::instance().ticks_per_ns();
+
+    bench::TickToTradeReport report;
+    state.set_items_per_iteration(static_cast<double>(cfg.packets));
+    state.run([&]() {
+        report = bench::run_tick_to_trade(cfg);
+        state.record_latency_ticks(report.wire_to_wire, ns_per_tick);
+    });
+
+    const std::string problem = check_tick_to_trade(report, cfg.packets);
+    if (!problem.empty()) state.error(problem);
+}
+FWILLIAMSCA_BENCHMARK(bench_tick_to_trade)->samples(3);
+
+/**
+ * @brief --t2t[=Mpps]: one longer run with the per-hop breakdown and
+ * per-stage counters. A rate of 0 feeds packets as fast as possible.
+ */
+int run_tick_to_trade_report(double rate_mpps) {
+    bench::TickToTradeConfig cfg = tick_to_trade_config();
+    cfg.packets = 1000000;
+    cfg.feed_rate_mpps = rate_mpps;
+    const double ns_per_tick = 1.0 / timing::TscClock::instance().ticks_per_ns();
+
+    char rate[32];
+    if (rate_mpps > 0.0) {
+        std::snprintf(rate, sizeof(rate), "%.2f Mpps", rate_mpps);
+    } else {
+        std::snprintf(rate, sizeof(rate), "max rate");
+    }
+    std::printf("[T2T] %zu packets at %s, %zu instruments, stages %s\n", cfg.packets, rate, cfg.instruments,
+                cfg.cores.empty() ? "unpinned" : "pinned one per CPU");
+    const bench::TickToTradeReport r = bench::run_tick_to_trade(cfg);
+
+    std::printf("  %-12s ", "wire-to-wire");
+    r.wire_to_wire.print(stdout, "ns", ns_per_tick);
+    for (size_t h = 0; h < bench::HopCount; ++h) {
+        std::printf("  %-12s ", bench::hop_name(h));
+        r.hops[h].print(stdout, "ns", ns_per_tick);
+    }
+    std::printf("\n  %-12s %10s %10s %10s %8s %12s %14s\n", "stage", "in", "out", "filtered", "stalls", "cycles/msg",
+                "max batch cyc");
+    for (const auto& [name, s] : r.stages) {
+        std::printf("  %-12s %10llu %10llu %10llu %8llu %12.1f %14llu\n", name.c_str(),
+                    static_cast<unsigned long long>(s.messages_in), static_cast<unsigned long long>(s.messages_out),
+                    static_cast<unsigned long long>(s.filtered), static_cast<unsigned long long>(s.stalls),
+                    s.cycles_per_message(), static_cast<unsigned long long>(s.max_batch_cycles));
+    }
+    std::printf("\n  exchange: %llu orders, %llu filled, %llu missed (stale price); %.2f s\n",
+                static_cast<unsigned long long>(r.exchange.orders), static_cast<unsigned long long>(r.exchange.fills),
+                static_cast<unsigned long long>(r.exchange.misses), r.seconds);
+    const std::string problem = check_tick_to_trade(r, cfg.packets);
+    if (!problem.empty()) {
+        std::printf("  [FAIL] %s\n", problem.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+async::Task consume_ring(memory::SPSCRingBuffer<int, 1024>& ring, int count, long& sum) {
+    for (int i = 0; i < count; ++i) {
+        sum += co_await async::pop(ring);
+    }
+}
+
+void bench_ring_executor(bench::State& state) {
+    constexpr int Rings = 32;
+    constexpr int PerRing = 100000;
+    std::array<memory::SPSCRingBuffer<int, 1024>, Rings> rings;
+
+    long sum = 0;
+    state.set_items_per_iteration(static_cast<double>(Rings) * PerRing);
+    state.run([&]() {
+        sum = 0;
+        async::RingExecutor executor;
+        for (auto& ring : rings) {
+            executor.spawn(consume_ring(ring, PerRing, sum));
+        }
+        std::thread producer([&]() {
+            for (int i = 0; i < PerRing; ++i) {
+                for (auto& ring : rings) {
+                    while (!ring.try_push(1)) std::this_thread::yield();
+                }
+            }
+        });
+        executor.run();
+        producer.join();
     });
 
-    // Producer Loop
-    auto start = std::chrono::high_resolution_clock::now();
-    for (int i = 0; i < 1000000; ++i) {
-        while (!ring.try_push(i)) {
-            _mm_pause(); // Intel pause instruction
+    if (sum != static_cast<long>(Rings) * PerRing) {
+        state.error("sum " + std::to_string(sum));
+    }
+}
+FWILLIAMSCA_BENCHMARK(bench_ring_executor)->samples(5);
+
+// ============================================================================
+// Persistence
+// ============================================================================
+
+struct JournalTick {
+    uint64_t seq;
+    double px;
+    double qty;
+    uint64_t tsc;   // Stamped at enqueue; journaled as the record time
+};
+
+// Fresh private directory per benchmark, so no run depends on (or clobbers) another's files
+static std::string bench_journal_dir() {
+    std::string tmpl = (std::filesystem::temp_directory_path() / "fwilliamsca_journal.XXXXXX").string();
+    if (!mkdtemp(tmpl.data())) {
+        throw std::system_error(errno, std::generic_category(), "mkdtemp " + tmpl);
+    }
+    return tmpl;
+}
+
+void bench_journal_record(bench::State& state) {
+    constexpr uint64_t N = 1000000;
+    memory::SPSCRingBuffer<JournalTick, 4096> ring;
+    const std::string dir = bench_journal_dir();
+
+    uint64_t recorded = 0;
+    state.set_items_per_iteration(N);
+    state.run([&]() {
+        std::filesystem::remove_all(dir);
+        persistence::RingJournaler<decltype(ring)> journaler(ring, {dir, "ticks", size_t(16) << 20, true});
+        journaler.start();
+        for (uint64_t i = 0; i < N; ++i) {
+            const JournalTick tick{i, 100.0 + i * 0.01, 1.0, __rdtsc()};
+            while (!ring.try_push(tick)) std::this_thread::yield();
         }
+        journaler.stop();
+        recorded = journaler.writer().records();
+    });
+    std::filesystem::remove_all(dir);
+
+    if (recorded != N) {
+        state.error("recorded " + std::to_string(recorded));
     }
-    
-    done.store(true);
-    consumer.join();
-    auto end = std::chrono::high_resolution_clock::now();
-    
-    std::cout << "  > Throughput: " 
-              << 1000000.0 / std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() 
-              << " M ops/sec\n";
-    std::cout << "[PASS] Buffer Test Complete.\n";
 }
+FWILLIAMSCA_BENCHMARK(bench_journal_record)->samples(5);
 
-int main() {
+void bench_journal_replay(bench::State& state) {
+    constexpr uint64_t N = 1000000;
+    memory::SPSCRingBuffer<JournalTick, 4096> ring;
+
+    // Setup, outside the timed region: record the journal to replay
+    const std::string dir = bench_journal_dir();
+    {
+        persistence::JournalWriter writer({dir, "ticks", size_t(16) << 20, true});
+        for (uint64_t i = 0; i < N; ++i) writer.append(JournalTick{i, 100.0 + i * 0.01, 1.0, __rdtsc()});
+    }
+
+    uint64_t checksum = 0;
+    state.set_items_per_iteration(N);
+    state.run([&]() {
+        persistence::JournalReader reader(dir, "ticks");
+        uint64_t replayed = 0;
+        checksum = 0;
+        std::thread consumer([&]() {
+            JournalTick t;
+            while (replayed < N) {
+                if (ring.try_pop(t)) {
+                    checksum += t.seq;
+                    ++replayed;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        reader.replay(ring, persistence::ReplaySpeed::Max);
+        consumer.join();
+    });
+    std::filesystem::remove_all(dir);
+
+    if (checksum != (N - 1) * N / 2) {
+        state.error("checksum " + std::to_string(checksum));
+    }
+}
+FWILLIAMSCA_BENCHMARK(bench_journal_replay)->samples(5);
+
+int main(int argc, char** argv) {
     std::cout << "=== F.WilliamsCA High-Performance Utils ===\n";
     std::cout << "Architecture Detected: ";
 #if defined(__AVX512F__)
@@ -96,10 +1652,108 @@ int main() {
 #else
     std::cout << "Scalar (Fallback)\n";
 #endif
+    std::cout << "Host ISA tiers:";
+    for (simd::ISA isa : {simd::ISA::Scalar, simd::ISA::AVX2, simd::ISA::AVX512_VL, simd::ISA::AVX512_F}) {
+        if (simd::cpu_supports(isa)) std::cout << " " << simd::to_string(isa);
+    }
+    std::cout << "\n";
+    const timing::TscClock& tsc = timing::TscClock::instance();
+    std::cout << "TSC: " << tsc.ghz() << " GHz" << (tsc.invariant() ? " (invariant)" : " (NOT invariant, using steady_clock)")
+              << ", start/stop overhead " << tsc.overhead_ticks() << " ticks\n";
     std::cout << "-------------------------------------------\n";
 
-    bench_avx512_dot_product();
-    bench_ring_buffer();
+    bench::Config cfg;
+    bench::ReportConfig report;
+    bool c2c = false;
+    bool sweep = false;
+    bool jitter = false;
+    double freq_seconds = 0.0;
+    bool t2t = false;
+    double t2t_rate = 1.0;
+    JitterConfig jitter_cfg;
+    std::string trace_path;
+    std::vector<std::string> args = bench::parse_args(argc, argv, cfg);
+    bench::parse_report_args(args, report);
+    for (const auto& arg : args) {
+        if (arg == "--c2c") {
+            c2c = true;
+        } else if (arg == "--sweep") {
+            sweep = true;
+        } else if (arg == "--jitter") {
+            jitter = true;
+        } else if (arg == "--t2t") {
+            t2t = true;
+        } else if (arg.rfind("--t2t=", 0) == 0) {
+            t2t = true;
+            t2t_rate = std::stod(arg.substr(6));
+            if (t2t_rate < 0.0) {
+                std::cerr << "--t2t rate must be >= 0 Mpps (0 = as fast as possible)\n";
+                return 2;
+            }
+        } else if (arg == "--freq") {
+            freq_seconds = 0.5;
+        } else if (arg.rfind("--freq=", 0) == 0) {
+            freq_seconds = std::stod(arg.substr(7));
+        } else if (arg.rfind("--interferers=", 0) == 0) {
+            jitter_cfg.interferers = {bench::Interferer::None};
+            for (size_t pos = 14; pos <= arg.size();) {
+                const size_t comma = std::min(arg.find(',', pos), arg.size());
+                bench::Interferer kind;
+                if (!bench::parse_interferer(arg.substr(pos, comma - pos), kind)) {
+                    std::cerr << "Unknown interferer in " << arg
+                              << " (expected memory-bw, llc-thrash, avx512, syscall)\n";
+                    return 2;
+                }
+                if (kind != bench::Interferer::None) jitter_cfg.interferers.push_back(kind);
+                pos = comma + 1;
+            }
+        } else if (arg.rfind("--noise-cpus=", 0) == 0) {
+            jitter_cfg.noise_cpus = parse_cpu_list(arg.substr(13));
+        } else if (arg.rfind("--jitter-time=", 0) == 0) {
+            jitter_cfg.seconds = std::stod(arg.substr(14));
+        } else if (arg.rfind("--trace=", 0) == 0) {
+            trace_path = arg.substr(8);
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 2;
+        }
+    }
+    if (c2c) {
+        return run_c2c_matrix(100000);
+    }
+    if (sweep) {
+        return run_bandwidth_sweep(cfg);
+    }
+    if (jitter) {
+        return run_jitter(cfg, jitter_cfg);
+    }
+    if (freq_seconds > 0.0) {
+        return run_frequency_license(freq_seconds);
+    }
+    if (t2t) {
+        return run_tick_to_trade_report(t2t_rate);
+    }
+
+    // --trace=<file>: Chrome trace of every trace point hit during the run
+    std::unique_ptr<trace::TraceSession> session;
+    if (!trace_path.empty()) {
+#if !defined(FWILLIAMSCA_TRACE)
+        std::cerr << "--trace has no trace points to record: rebuild with -DFWILLIAMSCA_TRACE\n";
+#endif
+        session = std::make_unique<trace::TraceSession>(trace_path);
+    }
 
-    return 0;
-}
\ No newline at end of file
+    int status = 0;
+    const std::vector<bench::Result> results = bench::run_benchmarks(cfg);
+    if (session) {
+        session->stop();
+        std::cout << "Trace: " << session->events_written() << " events written to " << trace_path << ", "
+                  << session->dropped() << " dropped\n";
+    }
+    for (const auto& r : results) {
+        if (!r.error.empty()) status = 1;
+    }
+    print_isa_speedups(results);
+    const int report_status = bench::report_results(report, results);
+    return report_status != 0 ? report_status : status;
+}